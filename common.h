@@ -12,11 +12,26 @@
 
 // Rendering settings
 #define PROPS_RENDER_SCALE 0.3 // prop resolution scale
+#define PROPS_UPSAMPLE_DEPTH_TOLERANCE 0.02f // Props this fraction of the distance behind the full-res scene fade out
+
+// Dynamic props resolution (F5): the scale steps within [MIN, MAX] to keep the props pass's GPU time near
+// the budget. quarterResTarget is allocated once at MAX and props render into a corner of it.
+#define PROPS_RENDER_SCALE_MIN 0.15f
+#define PROPS_RENDER_SCALE_MAX 0.5f
+#define PROPS_DYNRES_BUDGET_MS 3.0f    // Props pass GPU time to hold (quarter-res props + grass OIT)
+#define PROPS_DYNRES_INTERVAL 8        // Frames between scale steps
+#define PROPS_DYNRES_STEP 0.025f
+#define PROPS_TIMER_QUERIES 4          // GPU timer ring; results are read this many frames late, without stalling
 
 // DOF in world meters from camera: no blur at or below DOF_SHARP_RADIUS_M; full blur by DOF_BLUR_FULL_DIST_M
 #define DOF_SHARP_RADIUS_M 4.0f
 #define DOF_BLUR_FULL_DIST_M 55.0f
-#define DOF_GAUSSIAN_PIXEL_SCALE 0.01f // wider separable blur before distance mix
+// The blur runs on a chain of DOF_BLUR_LEVELS 2x downsamples (1 = half, 2 = quarter resolution), so its cost
+// is set by the chain depth while DOF_BLUR_RADIUS_PX sets how wide it looks
+#define DOF_BLUR_LEVELS 2
+#define DOF_BLUR_RADIUS_PX 8.0f // Gaussian reach in full-res pixels
+#define DOF_TILE_SIZE 16          // Screen tiles classified sharp / transition / blurred from their depth range
+#define DOF_TILE_READBACK_SLOTS 2 // PBO ring for the overlay's tile histogram
 // Texture filter modes:
 // TEXTURE_FILTER_POINT - Nearest-neighbor filtering (pixelated)
 // TEXTURE_FILTER_BILINEAR - Linear filtering (smooth)
@@ -38,9 +53,41 @@ static inline void ApplyTextureFilterToAllMaterialMaps(Model model, int filter)
     }
 }
 
-// Terrain texture tiling density across full terrain dimensions (higher = more repeats)
+// Terrain texture tiling density: repeats per 500 m of ground (higher = more repeats)
 #define TERRAIN_UV_REPEAT 180.0f
 
+// Streaming world: square tiles of terrain and props generated on a background thread. The resident
+// window of WORLD_WINDOW_TILES^2 tiles follows the camera; tiles leaving it are evicted, so the window
+// is the memory budget. Tile (x, z) lives in slot (x mod WORLD_WINDOW_TILES, z mod WORLD_WINDOW_TILES).
+#define WORLD_TILE_QUADS 128           // Heightfield cells per tile edge (TERRAIN_PATCH_QUADS * 2^n)
+#define WORLD_CELL_SIZE 0.48828125f    // Meters between heightfield samples (500 m / 1024)
+#define WORLD_TILE_SIZE (WORLD_TILE_QUADS * WORLD_CELL_SIZE) // 62.5 m
+#define WORLD_WINDOW_TILES 8           // Resident tiles per window edge (500 m)
+#define WORLD_STREAM_BUFFERS 4         // Generated tiles that may wait for the main thread
+#define WORLD_COMMITS_PER_FRAME 2      // Finished tiles uploaded per frame, so uploads never bunch up
+#define WORLD_STARTUP_RADIUS 1         // Tiles around the camera generated before the first frame
+#define WORLD_GENERATOR_WORKERS 2      // Private pool helping the generator thread with terrain noise rows
+#define WORLD_CACHE_DIR "world_cache"  // Baked tiles, one subdirectory per seed and generation parameters
+#define WORLD_CACHE_MAX_WORLDS 4       // Seed subdirectories kept; the least recently used are deleted at startup
+#define WORLD_DEFAULT_SEED 0x5eed1234u // Seed when none is passed, so plain launches reuse one baked world
+#define WORLD_FILE_VERSION 2           // Bump when the tile file layout or any terrain/prop generator changes
+
+static inline int WorldFloorDiv(int a, int b) {
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+static inline int GetWorldTileSlot(int tileX, int tileZ) {
+    int sx = tileX - WorldFloorDiv(tileX, WORLD_WINDOW_TILES) * WORLD_WINDOW_TILES;
+    int sz = tileZ - WorldFloorDiv(tileZ, WORLD_WINDOW_TILES) * WORLD_WINDOW_TILES;
+    return sz * WORLD_WINDOW_TILES + sx;
+}
+
+// CDLOD terrain: every tile is one quadtree root of WORLD_TILE_QUADS cells
+#define TERRAIN_PATCH_QUADS 16         // Quads per edge of the shared grid patch every node draws
+#define TERRAIN_LOD_NEAR_RANGE 36.0f   // Range of the finest level; doubles per level (keep > 3x a leaf node's diagonal)
+#define TERRAIN_LOD_MORPH_START 0.66f  // Fraction of a level's range band where morphing to the next level begins
+#define TERRAIN_NODE_ATTRIB_LOCATION 10 // Per-instance node streams in terrain.vs (this and the next location)
+
 // How many times the rock diffuse repeats per mesh UV unit (needs TEXTURE_WRAP_REPEAT on rock texture)
 #define PROPS_ROCK_UV_REPEAT 6.0f
 
@@ -50,8 +97,31 @@ static inline void ApplyTextureFilterToAllMaterialMaps(Model model, int filter)
 // LOS (Line of Sight) optimization settings
 #define LOS_MIN_CAMERA_MOVE 0.5f       // Minimum distance camera must move before rechecking visibility
 #define LOS_MAX_GRASS_DISTANCE 45.0f   // Max grass visibility distance for cheap CPU culling
-#define LOS_MAX_ROCK_DISTANCE 80.0f    // Max rock visibility distance for cheap CPU culling
-#define LOS_TERRAIN_SAMPLES 8          // Cheap terrain occlusion samples per prop ray
+#define LOS_MAX_ROCK_DISTANCE 120.0f   // Max rock visibility distance for cheap CPU culling
+#define LOS_TERRAIN_TOLERANCE 0.15f    // Terrain must rise this far above a prop ray to block it
+#define LOS_RAY_END_TRIM 0.75f         // Meters before the prop where terrain is ignored (props sit in the ground)
+#define LOS_TIME_SLICE_BUDGET_US 1500  // Per-frame LOS budget when time slicing is on (microseconds)
+#define HIZ_LEVELS 4                   // 2x2 max reductions of the full-res depth before CPU readback (1280x720 -> 80x45)
+
+// Uniform grid over the resident window; LOS, culling and debug only walk cells overlapping the view radius
+#define PROPS_GRID_CELLS_PER_TILE 4    // Grid cells per world tile edge (15.6 m cells)
+#define PROPS_TILE_CAPACITY 4096       // Prop slots per tile; a multiple of 2048 so a tile owns whole instance texture rows
+#define PROPS_SCATTER_CHUNKS 8         // Scatter chunks per tile edge (7.8 m); even, chunks fill in parallel in 2x2 phases
+#define PROPS_SCATTER_CANDIDATES 6     // Best-candidate darts per prop (more = spacing closer to Poisson-disk)
+#define PROPS_GRID_PROP_HEIGHT 1.5f    // Slack around cell bounds for cell culling (tallest prop, largest half-extent)
+#define PROPS_FRUSTUM_MARGIN 0.5f      // World-space slack on every frustum plane to avoid popping at the edges
+#define PROPS_GRASS_SORT_ESTIMATE_FRAMES 30 // With OIT grass, frames between scratch sorts that measure what OIT saves
+#define PROPS_JOB_CELL_GRAIN 2         // Grid cells per job chunk for parallel LOS and culling
+
+// GPU instancing: per-prop transforms in a float texture, visible indices streamed per frame
+#define PROPS_INSTANCE_TEXTURE_WIDTH 2048  // Texels per row of the instance data texture
+#define PROPS_INSTANCE_ATTRIB_LOCATION 10  // Must match layout(location) in lighting_instanced.vs
+
+// Rock LOD: octahedral impostor cards baked from the rock model at startup
+#define PROPS_IMPOSTOR_DISTANCE 40.0f      // Rocks beyond this draw as impostor cards
+#define PROPS_IMPOSTOR_FADE_BAND 6.0f      // Width of the dithered mesh/impostor crossfade (meters)
+#define PROPS_IMPOSTOR_FRAMES 12           // Hemi-octahedral views per atlas side
+#define PROPS_IMPOSTOR_FRAME_SIZE 64       // Pixels per baked view
 
 // Game state
 typedef struct {
@@ -0,0 +1,172 @@
+#include "culling.h"
+#include "rlgl.h"   // Required for rlGetCullDistanceNear and rlGetCullDistanceFar
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+static Vector4 NormalizePlane(float a, float b, float c, float d) {
+    float len = sqrtf(a * a + b * b + c * c);
+    if (len <= 0.0f) return (Vector4){ 0.0f, 0.0f, 0.0f, d };
+    return (Vector4){ a / len, b / len, c / len, d / len };
+}
+
+Matrix GetCameraViewProjection(Camera3D camera, float aspect) {
+    Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+    Matrix proj;
+    if (camera.projection == CAMERA_ORTHOGRAPHIC) {
+        double top = camera.fovy / 2.0;
+        double right = top * aspect;
+        proj = MatrixOrtho(-right, right, -top, top, rlGetCullDistanceNear(), rlGetCullDistanceFar());
+    } else {
+        proj = MatrixPerspective(camera.fovy * DEG2RAD, aspect, rlGetCullDistanceNear(), rlGetCullDistanceFar());
+    }
+    return MatrixMultiply(view, proj);
+}
+
+Frustum ExtractCameraFrustum(Camera3D camera, float aspect) {
+    Matrix m = GetCameraViewProjection(camera, aspect);
+
+    // Gribb/Hartmann: clip = row_i . (p, 1); planes are row3 +/- row0..2
+    Frustum frustum;
+    frustum.planes[0] = NormalizePlane(m.m3 + m.m0, m.m7 + m.m4, m.m11 + m.m8, m.m15 + m.m12);
+    frustum.planes[1] = NormalizePlane(m.m3 - m.m0, m.m7 - m.m4, m.m11 - m.m8, m.m15 - m.m12);
+    frustum.planes[2] = NormalizePlane(m.m3 + m.m1, m.m7 + m.m5, m.m11 + m.m9, m.m15 + m.m13);
+    frustum.planes[3] = NormalizePlane(m.m3 - m.m1, m.m7 - m.m5, m.m11 - m.m9, m.m15 - m.m13);
+    frustum.planes[4] = NormalizePlane(m.m3 + m.m2, m.m7 + m.m6, m.m11 + m.m10, m.m15 + m.m14);
+    frustum.planes[5] = NormalizePlane(m.m3 - m.m2, m.m7 - m.m6, m.m11 - m.m10, m.m15 - m.m14);
+    return frustum;
+}
+
+bool IsSphereInFrustum(const Frustum* frustum, Vector3 center, float radius) {
+    for (int p = 0; p < 6; p++) {
+        Vector4 pl = frustum->planes[p];
+        if (pl.x * center.x + pl.y * center.y + pl.z * center.z + pl.w < -radius) return false;
+    }
+    return true;
+}
+
+bool IsBoxInFrustum(const Frustum* frustum, BoundingBox box) {
+    for (int p = 0; p < 6; p++) {
+        Vector4 pl = frustum->planes[p];
+        float x = (pl.x >= 0.0f) ? box.max.x : box.min.x;
+        float y = (pl.y >= 0.0f) ? box.max.y : box.min.y;
+        float z = (pl.z >= 0.0f) ? box.max.z : box.min.z;
+        if (pl.x * x + pl.y * y + pl.z * z + pl.w < 0.0f) return false;
+    }
+    return true;
+}
+
+static bool IsPointInsidePlanes(const Frustum* frustum, float x, float y, float z, float margin) {
+    for (int p = 0; p < 6; p++) {
+        Vector4 pl = frustum->planes[p];
+        if (pl.x * x + pl.y * y + pl.z * z + pl.w + margin < 0.0f) return false;
+    }
+    return true;
+}
+
+int CullPointsFrustum(const Frustum* frustum, const float* xs, const float* ys, const float* zs, int count, float margin, int* outIndices) {
+    int written = 0;
+    int i = 0;
+
+#if defined(__AVX__)
+    __m256 avxNx[6], avxNy[6], avxNz[6], avxW[6];
+    for (int p = 0; p < 6; p++) {
+        avxNx[p] = _mm256_set1_ps(frustum->planes[p].x);
+        avxNy[p] = _mm256_set1_ps(frustum->planes[p].y);
+        avxNz[p] = _mm256_set1_ps(frustum->planes[p].z);
+        avxW[p] = _mm256_set1_ps(frustum->planes[p].w + margin);
+    }
+    const __m256 avxZero = _mm256_setzero_ps();
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(xs + i);
+        __m256 y = _mm256_loadu_ps(ys + i);
+        __m256 z = _mm256_loadu_ps(zs + i);
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int p = 0; p < 6; p++) {
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(avxNx[p], x), _mm256_mul_ps(avxNy[p], y)),
+                                     _mm256_add_ps(_mm256_mul_ps(avxNz[p], z), avxW[p]));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, avxZero, _CMP_GE_OQ));
+        }
+        int mask = _mm256_movemask_ps(inside);
+        while (mask) {
+            int lane = __builtin_ctz((unsigned int)mask);
+            outIndices[written++] = i + lane;
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+#if defined(__SSE2__)
+    __m128 sseNx[6], sseNy[6], sseNz[6], sseW[6];
+    for (int p = 0; p < 6; p++) {
+        sseNx[p] = _mm_set1_ps(frustum->planes[p].x);
+        sseNy[p] = _mm_set1_ps(frustum->planes[p].y);
+        sseNz[p] = _mm_set1_ps(frustum->planes[p].z);
+        sseW[p] = _mm_set1_ps(frustum->planes[p].w + margin);
+    }
+    const __m128 sseZero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(xs + i);
+        __m128 y = _mm_loadu_ps(ys + i);
+        __m128 z = _mm_loadu_ps(zs + i);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int p = 0; p < 6; p++) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(sseNx[p], x), _mm_mul_ps(sseNy[p], y)),
+                                  _mm_add_ps(_mm_mul_ps(sseNz[p], z), sseW[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, sseZero));
+        }
+        int mask = _mm_movemask_ps(inside);
+        while (mask) {
+            int lane = __builtin_ctz((unsigned int)mask);
+            outIndices[written++] = i + lane;
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        if (IsPointInsidePlanes(frustum, xs[i], ys[i], zs[i], margin)) outIndices[written++] = i;
+    }
+    return written;
+}
+
+bool IsBoxOccludedHiZ(const HiZBuffer* hiz, BoundingBox box) {
+    if (!hiz->valid) return false;
+    const Matrix m = hiz->viewProj;
+    float minX = 1.0f, minY = 1.0f, maxX = -1.0f, maxY = -1.0f;
+    float nearestDepth = 1.0f;
+    for (int corner = 0; corner < 8; corner++) {
+        float x = (corner & 1) ? box.max.x : box.min.x;
+        float y = (corner & 2) ? box.max.y : box.min.y;
+        float z = (corner & 4) ? box.max.z : box.min.z;
+        float w = m.m3 * x + m.m7 * y + m.m11 * z + m.m15;
+        if (w <= 1e-4f) return false; // Box reaches behind the camera: cannot be occluded safely
+        float invW = 1.0f / w;
+        float nx = (m.m0 * x + m.m4 * y + m.m8 * z + m.m12) * invW;
+        float ny = (m.m1 * x + m.m5 * y + m.m9 * z + m.m13) * invW;
+        float depth = (m.m2 * x + m.m6 * y + m.m10 * z + m.m14) * invW * 0.5f + 0.5f;
+        minX = fminf(minX, nx);
+        maxX = fmaxf(maxX, nx);
+        minY = fminf(minY, ny);
+        maxY = fmaxf(maxY, ny);
+        nearestDepth = fminf(nearestDepth, depth);
+    }
+    // Any part outside the recorded view may be visible now (the Hi-Z is a frame old)
+    if (minX < -1.0f || maxX > 1.0f || minY < -1.0f || maxY > 1.0f) return false;
+
+    // NDC rect -> texel range (rows bottom-up like the GL framebuffer)
+    int x0 = (int)((minX * 0.5f + 0.5f) * (float)hiz->width);
+    int x1 = (int)((maxX * 0.5f + 0.5f) * (float)hiz->width);
+    int y0 = (int)((minY * 0.5f + 0.5f) * (float)hiz->height);
+    int y1 = (int)((maxY * 0.5f + 0.5f) * (float)hiz->height);
+    if (x1 >= hiz->width) x1 = hiz->width - 1;
+    if (y1 >= hiz->height) y1 = hiz->height - 1;
+    for (int ty = y0; ty <= y1; ty++) {
+        const float* row = hiz->depth + (size_t)ty * (size_t)hiz->width;
+        for (int tx = x0; tx <= x1; tx++) {
+            if (row[tx] >= nearestDepth) return false; // Something behind the box's nearest point is visible
+        }
+    }
+    return true;
+}
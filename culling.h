@@ -0,0 +1,43 @@
+#ifndef CULLING_H
+#define CULLING_H
+
+#include "common.h"
+
+// View frustum as six inward-facing planes (xyz = unit normal, w = offset); a point p is
+// inside a plane when dot(xyz, p) + w >= 0. Order: left, right, bottom, top, near, far.
+typedef struct {
+    Vector4 planes[6];
+} Frustum;
+
+// View-projection matching BeginMode3D for a framebuffer of the given aspect
+Matrix GetCameraViewProjection(Camera3D camera, float aspect);
+
+// Extract frustum planes once per frame from the camera's view-projection (same matrices as BeginMode3D)
+Frustum ExtractCameraFrustum(Camera3D camera, float aspect);
+
+// Sphere test against all six planes (used for whole grid cells)
+bool IsSphereInFrustum(const Frustum* frustum, Vector3 center, float radius);
+
+// Box test against all six planes using each plane's most positive corner (used for terrain nodes)
+bool IsBoxInFrustum(const Frustum* frustum, BoundingBox box);
+
+// Batched point test over SoA coordinates; every plane is pushed out by margin (world units).
+// Writes the local indices (0..count-1) of points inside to outIndices and returns how many passed.
+// Uses AVX (8 lanes) or SSE (4 lanes) when the compiler targets them, with a scalar tail/fallback.
+int CullPointsFrustum(const Frustum* frustum, const float* xs, const float* ys, const float* zs, int count, float margin, int* outIndices);
+
+// CPU copy of a coarse farthest-depth (max) level of the scene depth, and the view-projection of the
+// frame it was rendered with. Rows are bottom-up (glReadPixels order); values are window depth in [0, 1].
+typedef struct {
+    int width;
+    int height;
+    float* depth;
+    Matrix viewProj;
+    bool valid;       // False until the first readback lands
+} HiZBuffer;
+
+// True when the whole box lies behind the recorded depth. Conservative: boxes that reach behind the
+// camera or leave the recorded view are never reported occluded.
+bool IsBoxOccludedHiZ(const HiZBuffer* hiz, BoundingBox box);
+
+#endif // CULLING_H
@@ -0,0 +1,255 @@
+#include "framegraph.h"
+#include <stdlib.h>
+
+typedef struct {
+    const char* name;
+    FramePassFn fn;
+    void* userData;
+    int reads[FRAME_GRAPH_MAX_PASS_IO];
+    int readCount;
+    int writes[FRAME_GRAPH_MAX_PASS_IO];
+    int writeCount;
+    bool sideEffect;
+    bool culled;
+} FramePass;
+
+typedef struct {
+    const char* name;
+    bool imported;
+    RenderTexture2D target;  // Imported target, or the pooled texture while the resource is live
+    int width;
+    int height;
+    int filter;
+    int firstPass;           // Lifetime over the surviving passes (-1 = unused this frame)
+    int lastPass;
+    int poolSlot;            // -1 = not pooled
+} FrameResource;
+
+typedef struct {
+    RenderTexture2D target;
+    int filter;
+    bool inUse;
+    int lastUsedFrame;
+} FramePoolEntry;
+
+struct FrameGraphState {
+    FramePass passes[FRAME_GRAPH_MAX_PASSES];
+    FrameResource resources[FRAME_GRAPH_MAX_RESOURCES];
+    int resourceCount;
+    FramePoolEntry pool[FRAME_GRAPH_POOL_SIZE];
+    int frame;
+};
+
+FrameGraph InitFrameGraph(void) {
+    FrameGraph graph = {0};
+    graph.state = (FrameGraphState*)calloc(1, sizeof(FrameGraphState));
+    return graph;
+}
+
+void BeginFrameGraph(FrameGraph* graph) {
+    graph->passCount = 0;
+    graph->state->resourceCount = 0;
+}
+
+static int AddFrameResource(FrameGraph* graph, const char* name) {
+    FrameGraphState* state = graph->state;
+    if (state->resourceCount >= FRAME_GRAPH_MAX_RESOURCES) {
+        printf("ERROR: Frame graph resource limit reached, dropping %s\n", name);
+        return -1;
+    }
+    int index = state->resourceCount++;
+    state->resources[index] = (FrameResource){ .name = name, .firstPass = -1, .lastPass = -1, .poolSlot = -1 };
+    return index;
+}
+
+int ImportFrameTarget(FrameGraph* graph, const char* name, RenderTexture2D target) {
+    int index = AddFrameResource(graph, name);
+    if (index < 0) return index;
+    FrameResource* resource = &graph->state->resources[index];
+    resource->imported = true;
+    resource->target = target;
+    resource->width = target.texture.width;
+    resource->height = target.texture.height;
+    return index;
+}
+
+int CreateFrameTarget(FrameGraph* graph, const char* name, int width, int height, int filter) {
+    int index = AddFrameResource(graph, name);
+    if (index < 0) return index;
+    FrameResource* resource = &graph->state->resources[index];
+    resource->width = (width > 0) ? width : 1;
+    resource->height = (height > 0) ? height : 1;
+    resource->filter = filter;
+    return index;
+}
+
+int AddFramePass(FrameGraph* graph, const char* name, FramePassFn fn, void* userData) {
+    if (graph->passCount >= FRAME_GRAPH_MAX_PASSES) {
+        printf("ERROR: Frame graph pass limit reached, dropping %s\n", name);
+        return -1;
+    }
+    int index = graph->passCount++;
+    graph->state->passes[index] = (FramePass){ .name = name, .fn = fn, .userData = userData };
+    return index;
+}
+
+void FrameRead(FrameGraph* graph, int pass, int resource) {
+    if (pass < 0 || resource < 0) return;
+    FramePass* p = &graph->state->passes[pass];
+    if (p->readCount < FRAME_GRAPH_MAX_PASS_IO) p->reads[p->readCount++] = resource;
+}
+
+void FrameWrite(FrameGraph* graph, int pass, int resource) {
+    if (pass < 0 || resource < 0) return;
+    FramePass* p = &graph->state->passes[pass];
+    if (p->writeCount < FRAME_GRAPH_MAX_PASS_IO) p->writes[p->writeCount++] = resource;
+}
+
+void SetFramePassSideEffect(FrameGraph* graph, int pass) {
+    if (pass >= 0) graph->state->passes[pass].sideEffect = true;
+}
+
+// Walk back from the side-effect passes: a pass is needed if it writes something a later needed pass reads
+static void CullFramePasses(FrameGraph* graph) {
+    FrameGraphState* state = graph->state;
+    bool needed[FRAME_GRAPH_MAX_RESOURCES] = {0};
+    graph->culledCount = 0;
+    for (int p = graph->passCount - 1; p >= 0; p--) {
+        FramePass* pass = &state->passes[p];
+        bool live = pass->sideEffect;
+        for (int w = 0; w < pass->writeCount && !live; w++) live = needed[pass->writes[w]];
+        pass->culled = !live;
+        if (!live) {
+            graph->culledCount++;
+            continue;
+        }
+        for (int r = 0; r < pass->readCount; r++) needed[pass->reads[r]] = true;
+    }
+}
+
+static void TouchFrameResource(FrameResource* resource, int pass) {
+    if (resource->firstPass < 0) resource->firstPass = pass;
+    resource->lastPass = pass;
+}
+
+static void AcquirePooledTarget(FrameGraph* graph, FrameResource* resource) {
+    FrameGraphState* state = graph->state;
+    int freeSlot = -1;
+    for (int slot = 0; slot < FRAME_GRAPH_POOL_SIZE; slot++) {
+        FramePoolEntry* entry = &state->pool[slot];
+        if (entry->target.id == 0) {
+            if (freeSlot < 0) freeSlot = slot;
+            continue;
+        }
+        if (entry->inUse || entry->target.texture.width != resource->width || entry->target.texture.height != resource->height) continue;
+        resource->poolSlot = slot;
+        break;
+    }
+    if (resource->poolSlot < 0) {
+        if (freeSlot < 0) {
+            printf("ERROR: Frame graph pool full, %s is not allocated\n", resource->name);
+            return;
+        }
+        FramePoolEntry* entry = &state->pool[freeSlot];
+        entry->target = LoadRenderTexture(resource->width, resource->height);
+        entry->filter = -1;
+        graph->pooledTargets++;
+        graph->pooledBytes += (size_t)resource->width * (size_t)resource->height * 8;
+        resource->poolSlot = freeSlot;
+    }
+    FramePoolEntry* entry = &state->pool[resource->poolSlot];
+    if (entry->filter != resource->filter) {
+        SetTextureFilter(entry->target.texture, resource->filter);
+        entry->filter = resource->filter;
+    }
+    entry->inUse = true;
+    entry->lastUsedFrame = state->frame;
+    resource->target = entry->target;
+}
+
+static void TrimFramePool(FrameGraph* graph) {
+    FrameGraphState* state = graph->state;
+    for (int slot = 0; slot < FRAME_GRAPH_POOL_SIZE; slot++) {
+        FramePoolEntry* entry = &state->pool[slot];
+        if (entry->target.id == 0 || state->frame - entry->lastUsedFrame < FRAME_GRAPH_POOL_IDLE_FRAMES) continue;
+        graph->pooledTargets--;
+        graph->pooledBytes -= (size_t)entry->target.texture.width * (size_t)entry->target.texture.height * 8;
+        UnloadRenderTexture(entry->target);
+        *entry = (FramePoolEntry){0};
+    }
+}
+
+static void DumpFrameGraph(const FrameGraph* graph) {
+    const FrameGraphState* state = graph->state;
+    printf("INFO: Frame graph, frame %d: %d passes (%d culled), %d pooled targets (%.1f MB)\n", state->frame,
+           graph->passCount, graph->culledCount, graph->pooledTargets, (double)graph->pooledBytes / (1024.0 * 1024.0));
+    for (int p = 0; p < graph->passCount; p++) {
+        const FramePass* pass = &state->passes[p];
+        printf("  %2d %-14s%s", p, pass->name, pass->culled ? " culled" : (pass->sideEffect ? " side effect" : ""));
+        if (pass->readCount > 0) printf(" | reads");
+        for (int r = 0; r < pass->readCount; r++) printf(" %s", state->resources[pass->reads[r]].name);
+        if (pass->writeCount > 0) printf(" | writes");
+        for (int w = 0; w < pass->writeCount; w++) printf(" %s", state->resources[pass->writes[w]].name);
+        printf("\n");
+    }
+    for (int i = 0; i < state->resourceCount; i++) {
+        const FrameResource* resource = &state->resources[i];
+        printf("  %-14s %4dx%-4d ", resource->name, resource->width, resource->height);
+        if (resource->firstPass < 0) printf("unused\n");
+        else if (resource->imported) printf("imported, passes %d-%d\n", resource->firstPass, resource->lastPass);
+        else printf("pool %d, passes %d-%d\n", resource->poolSlot, resource->firstPass, resource->lastPass);
+    }
+}
+
+void ExecuteFrameGraph(FrameGraph* graph) {
+    FrameGraphState* state = graph->state;
+    state->frame++;
+    CullFramePasses(graph);
+
+    for (int p = 0; p < graph->passCount; p++) {
+        FramePass* pass = &state->passes[p];
+        if (pass->culled) continue;
+        for (int r = 0; r < pass->readCount; r++) TouchFrameResource(&state->resources[pass->reads[r]], p);
+        for (int w = 0; w < pass->writeCount; w++) TouchFrameResource(&state->resources[pass->writes[w]], p);
+    }
+
+    // Transient targets take a pool texture at their first pass and hand it back after their last,
+    // so later targets of the same size alias it. Assigned up front so the dump can show the result.
+    for (int p = 0; p < graph->passCount; p++) {
+        for (int i = 0; i < state->resourceCount; i++) {
+            FrameResource* resource = &state->resources[i];
+            if (!resource->imported && resource->firstPass == p) AcquirePooledTarget(graph, resource);
+        }
+        for (int i = 0; i < state->resourceCount; i++) {
+            FrameResource* resource = &state->resources[i];
+            if (!resource->imported && resource->lastPass == p && resource->poolSlot >= 0) state->pool[resource->poolSlot].inUse = false;
+        }
+    }
+    TrimFramePool(graph);
+
+    if (graph->dumpNextFrame) {
+        DumpFrameGraph(graph);
+        graph->dumpNextFrame = false;
+    }
+
+    for (int p = 0; p < graph->passCount; p++) {
+        FramePass* pass = &state->passes[p];
+        if (!pass->culled && pass->fn != NULL) pass->fn(graph, pass->userData);
+    }
+}
+
+RenderTexture2D GetFrameTarget(const FrameGraph* graph, int resource) {
+    if (resource < 0 || resource >= graph->state->resourceCount) return (RenderTexture2D){0};
+    return graph->state->resources[resource].target;
+}
+
+void UnloadFrameGraph(FrameGraph* graph) {
+    if (graph->state == NULL) return;
+    for (int slot = 0; slot < FRAME_GRAPH_POOL_SIZE; slot++) {
+        if (graph->state->pool[slot].target.id != 0) UnloadRenderTexture(graph->state->pool[slot].target);
+    }
+    free(graph->state);
+    graph->state = NULL;
+    graph->pooledTargets = 0;
+    graph->pooledBytes = 0;
+}
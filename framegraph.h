@@ -0,0 +1,61 @@
+#ifndef FRAMEGRAPH_H
+#define FRAMEGRAPH_H
+
+#include "common.h"
+
+#define FRAME_GRAPH_MAX_PASSES 32
+#define FRAME_GRAPH_MAX_RESOURCES 32
+#define FRAME_GRAPH_MAX_PASS_IO 8        // Reads, and separately writes, per pass
+#define FRAME_GRAPH_POOL_SIZE 16         // Pooled transient targets kept across frames
+#define FRAME_GRAPH_POOL_IDLE_FRAMES 120 // Pooled targets unused this long are freed
+
+typedef struct FrameGraphState FrameGraphState;
+typedef struct FrameGraph FrameGraph;
+
+// Runs one pass; GetFrameTarget resolves its resource handles. The pass binds its own targets.
+typedef void (*FramePassFn)(FrameGraph* graph, void* userData);
+
+// Passes are declared every frame in execution order, each listing the resources it reads and writes.
+// ExecuteFrameGraph culls passes nothing needs (nothing they write is read later by a needed pass, and
+// they have no side effects), gives each transient target a pooled RGBA8 texture for just the span of
+// passes between its first and last use, so targets whose lifetimes don't overlap share one texture,
+// and then runs the surviving passes. Writes count as read-modify-write: every earlier writer of a
+// resource a needed pass reads is kept.
+struct FrameGraph {
+    FrameGraphState* state;
+    int passCount;          // Declared this frame
+    int culledCount;        // Culled by the last ExecuteFrameGraph
+    int pooledTargets;      // Textures in the pool
+    size_t pooledBytes;     // Their colour + depth renderbuffer memory
+    bool dumpNextFrame;     // Print pass order and resource lifetimes on the next execute
+};
+
+FrameGraph InitFrameGraph(void);
+
+// Start declaring this frame's passes (clears the last frame's declarations, keeps the pool)
+void BeginFrameGraph(FrameGraph* graph);
+
+// Handle to a target the caller owns and keeps alive (never pooled or aliased)
+int ImportFrameTarget(FrameGraph* graph, const char* name, RenderTexture2D target);
+
+// Handle to a transient width x height RGBA8 target that only lives while passes use it; contents are
+// undefined until its first writer runs
+int CreateFrameTarget(FrameGraph* graph, const char* name, int width, int height, int filter);
+
+// Declare a pass; returns its handle for FrameRead/FrameWrite
+int AddFramePass(FrameGraph* graph, const char* name, FramePassFn fn, void* userData);
+void FrameRead(FrameGraph* graph, int pass, int resource);
+void FrameWrite(FrameGraph* graph, int pass, int resource);
+
+// Keep a pass even if nothing reads what it writes (presents, CPU readbacks)
+void SetFramePassSideEffect(FrameGraph* graph, int pass);
+
+// Cull, allocate, optionally dump, and run the declared passes in order
+void ExecuteFrameGraph(FrameGraph* graph);
+
+// Target behind a handle; transient targets are only valid while a pass that declared them runs
+RenderTexture2D GetFrameTarget(const FrameGraph* graph, int resource);
+
+void UnloadFrameGraph(FrameGraph* graph);
+
+#endif // FRAMEGRAPH_H
@@ -0,0 +1,188 @@
+#define GL_GLEXT_PROTOTYPES
+#include "hiz.h"
+#include "rlgl.h"
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <stdlib.h>
+#include <string.h>
+
+// rlgl has no pixel-pack buffers or fences, so the readback talks to GL directly
+struct HiZState {
+    Shader reduceShader;
+    int sourceLoc;
+    int sourceSizeLoc;
+    int levelCount;
+    unsigned int levelFbo[HIZ_MAX_LEVELS];
+    Texture2D levelTexture[HIZ_MAX_LEVELS];  // R32F, each half the size of the one before (rounded up)
+    GLuint pbo[HIZ_READBACK_SLOTS];
+    GLsync fence[HIZ_READBACK_SLOTS];        // NULL = slot idle
+    Matrix pboViewProj[HIZ_READBACK_SLOTS];
+    int writeSlot;
+};
+
+static unsigned int LoadHiZLevel(int width, int height, Texture2D* texture) {
+    unsigned int fbo = rlLoadFramebuffer();
+    if (fbo == 0) return 0;
+    texture->id = rlLoadTexture(NULL, width, height, PIXELFORMAT_UNCOMPRESSED_R32, 1);
+    texture->width = width;
+    texture->height = height;
+    texture->format = PIXELFORMAT_UNCOMPRESSED_R32;
+    texture->mipmaps = 1;
+    rlFramebufferAttach(fbo, texture->id, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+    if (!rlFramebufferComplete(fbo)) {
+        printf("ERROR: Hi-Z level %dx%d FBO incomplete\n", width, height);
+        rlUnloadFramebuffer(fbo);
+        rlUnloadTexture(texture->id);
+        *texture = (Texture2D){0};
+        return 0;
+    }
+    return fbo;
+}
+
+HiZPyramid InitHiZPyramid(int width, int height, int levels) {
+    HiZPyramid hiz = {0};
+    if (levels < 1) levels = 1;
+    if (levels > HIZ_MAX_LEVELS) levels = HIZ_MAX_LEVELS;
+
+    Shader reduce = LoadShader(NULL, "resources/shaders/hiz_reduce.fs");
+    if (reduce.id == 0) {
+        printf("ERROR: Failed to load Hi-Z reduction shader, occlusion culling disabled\n");
+        return hiz;
+    }
+
+    HiZState* state = (HiZState*)calloc(1, sizeof(HiZState));
+    state->reduceShader = reduce;
+    state->sourceLoc = GetShaderLocation(reduce, "sourceTex");
+    state->sourceSizeLoc = GetShaderLocation(reduce, "sourceSize");
+    int w = width;
+    int h = height;
+    for (int level = 0; level < levels; level++) {
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+        state->levelFbo[level] = LoadHiZLevel(w, h, &state->levelTexture[level]);
+        if (state->levelFbo[level] == 0) break;
+        state->levelCount++;
+    }
+    if (state->levelCount == 0) {
+        UnloadShader(reduce);
+        free(state);
+        return hiz;
+    }
+
+    Texture2D last = state->levelTexture[state->levelCount - 1];
+    glGenBuffers(HIZ_READBACK_SLOTS, state->pbo);
+    for (int slot = 0; slot < HIZ_READBACK_SLOTS; slot++) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, state->pbo[slot]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)last.width * last.height * (GLsizeiptr)sizeof(float), NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    hiz.buffer.width = last.width;
+    hiz.buffer.height = last.height;
+    hiz.buffer.depth = (float*)malloc((size_t)last.width * (size_t)last.height * sizeof(float));
+    hiz.buffer.valid = false;
+    hiz.state = state;
+    printf("INFO: Hi-Z occlusion: %d reductions, %dx%d CPU readback\n", state->levelCount, last.width, last.height);
+    return hiz;
+}
+
+// Copy a finished readback into the CPU buffer; leaves the slot pending if the GPU is not done yet
+static void CollectHiZReadback(HiZPyramid* hiz, int slot) {
+    HiZState* state = hiz->state;
+    if (state->fence[slot] == NULL) return;
+    GLenum status = glClientWaitSync(state->fence[slot], 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return;
+    glDeleteSync(state->fence[slot]);
+    state->fence[slot] = NULL;
+
+    size_t bytes = (size_t)hiz->buffer.width * (size_t)hiz->buffer.height * sizeof(float);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, state->pbo[slot]);
+    const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)bytes, GL_MAP_READ_BIT);
+    if (mapped != NULL) {
+        memcpy(hiz->buffer.depth, mapped, bytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        hiz->buffer.viewProj = state->pboViewProj[slot];
+        hiz->buffer.valid = true;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void UpdateHiZPyramid(HiZPyramid* hiz, Texture2D depth, Matrix viewProj) {
+    HiZState* state = hiz->state;
+    if (state == NULL) return;
+
+    // Max-reduce: level 0 reads the scene depth, every later level the one before it
+    Texture2D source = depth;
+    for (int level = 0; level < state->levelCount; level++) {
+        Texture2D target = state->levelTexture[level];
+        int sourceSize[2] = { source.width, source.height };
+        rlDrawRenderBatchActive();
+        rlEnableFramebuffer(state->levelFbo[level]);
+        rlViewport(0, 0, target.width, target.height);
+        BeginShaderMode(state->reduceShader);
+        SetShaderValueTexture(state->reduceShader, state->sourceLoc, source);
+        SetShaderValue(state->reduceShader, state->sourceSizeLoc, sourceSize, SHADER_UNIFORM_IVEC2);
+        rlDisableDepthTest();
+        rlDisableColorBlend();
+        // The shader works from gl_FragCoord, so any quad that covers the level will do
+        rlMatrixMode(RL_PROJECTION);
+        rlPushMatrix();
+        rlLoadIdentity();
+        rlOrtho(0, target.width, target.height, 0, 0.0, 1.0);
+        rlMatrixMode(RL_MODELVIEW);
+        rlPushMatrix();
+        rlLoadIdentity();
+        DrawRectangle(0, 0, target.width, target.height, WHITE);
+        rlDrawRenderBatchActive();
+        rlPopMatrix();
+        rlMatrixMode(RL_PROJECTION);
+        rlPopMatrix();
+        rlMatrixMode(RL_MODELVIEW);
+        rlEnableColorBlend();
+        EndShaderMode();
+        rlDisableFramebuffer();
+        source = target;
+    }
+    rlViewport(0, 0, GetRenderWidth(), GetRenderHeight());
+
+    // Pick up last frame's readback, then start this frame's into the other slot
+    int readSlot = (state->writeSlot + HIZ_READBACK_SLOTS - 1) % HIZ_READBACK_SLOTS;
+    CollectHiZReadback(hiz, readSlot);
+
+    int slot = state->writeSlot;
+    if (state->fence[slot] != NULL) {
+        // Still in flight after a full ring: drop it rather than stall
+        glDeleteSync(state->fence[slot]);
+        state->fence[slot] = NULL;
+    }
+    Texture2D last = state->levelTexture[state->levelCount - 1];
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, state->levelFbo[state->levelCount - 1]);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, state->pbo[slot]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, last.width, last.height, GL_RED, GL_FLOAT, NULL);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    state->fence[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    state->pboViewProj[slot] = viewProj;
+    state->writeSlot = (slot + 1) % HIZ_READBACK_SLOTS;
+}
+
+void UnloadHiZPyramid(HiZPyramid* hiz) {
+    HiZState* state = hiz->state;
+    if (state != NULL) {
+        for (int slot = 0; slot < HIZ_READBACK_SLOTS; slot++) {
+            if (state->fence[slot] != NULL) glDeleteSync(state->fence[slot]);
+        }
+        glDeleteBuffers(HIZ_READBACK_SLOTS, state->pbo);
+        for (int level = 0; level < state->levelCount; level++) {
+            rlUnloadFramebuffer(state->levelFbo[level]);
+            rlUnloadTexture(state->levelTexture[level].id);
+        }
+        UnloadShader(state->reduceShader);
+        free(state);
+    }
+    free(hiz->buffer.depth);
+    hiz->buffer.depth = NULL;
+    hiz->buffer.valid = false;
+    hiz->state = NULL;
+}
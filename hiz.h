@@ -0,0 +1,29 @@
+#ifndef HIZ_H
+#define HIZ_H
+
+#include "common.h"
+#include "culling.h"
+
+#define HIZ_MAX_LEVELS 8
+#define HIZ_READBACK_SLOTS 2   // PBO ring: one being written by the GPU while the other is read
+
+typedef struct HiZState HiZState;
+
+// Farthest-depth pyramid of the full-resolution scene depth. Each frame the GPU reduces the depth
+// HIZ_LEVELS times and starts an asynchronous readback of the last level; the readback started the
+// frame before is copied into buffer once its fence has signaled, so the CPU test runs one frame late
+// against the depth and camera of that frame.
+typedef struct {
+    HiZBuffer buffer;            // CPU side for IsBoxOccludedHiZ
+    HiZState* state;             // GL objects (NULL when the reduction shader failed to load)
+} HiZPyramid;
+
+HiZPyramid InitHiZPyramid(int width, int height, int levels);
+
+// Reduce depth (a sampleable depth texture of the initial width/height) and advance the readback ring.
+// viewProj is the camera the depth was rendered with.
+void UpdateHiZPyramid(HiZPyramid* hiz, Texture2D depth, Matrix viewProj);
+
+void UnloadHiZPyramid(HiZPyramid* hiz);
+
+#endif // HIZ_H
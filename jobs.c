@@ -0,0 +1,170 @@
+#define _POSIX_C_SOURCE 200809L
+#include "jobs.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// One chunk queue per participating thread; owner and thieves both claim chunks with fetch_add,
+// so stealing needs no locks. Padded to keep queues on separate cache lines.
+typedef struct {
+    int next;
+    int end;
+    char pad[56];
+} JobQueue;
+
+typedef struct {
+    JobSystemState* state;
+    int threadIndex;
+} JobWorkerArgs;
+
+struct JobSystemState {
+    pthread_t threads[JOBS_MAX_WORKERS];
+    JobWorkerArgs workerArgs[JOBS_MAX_WORKERS];
+    JobQueue queues[JOBS_MAX_WORKERS + 1];
+    int threadCount;             // workers + calling thread
+
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    unsigned int generation;     // Bumped per RunParallelFor; workers sleep until it changes
+    bool quit;
+
+    // Current batch (written before generation is bumped)
+    JobRangeFn fn;
+    void* userData;
+    int itemCount;
+    int grainSize;
+    int activeWorkers;           // Workers still inside the current batch
+};
+
+static bool ClaimChunk(JobSystemState* state, int queueIndex, int* chunk) {
+    JobQueue* queue = &state->queues[queueIndex];
+    if (__atomic_load_n(&queue->next, __ATOMIC_RELAXED) >= queue->end) return false;
+    int claimed = __atomic_fetch_add(&queue->next, 1, __ATOMIC_RELAXED);
+    if (claimed >= queue->end) return false;
+    *chunk = claimed;
+    return true;
+}
+
+static void RunChunks(JobSystemState* state, int threadIndex) {
+    int chunk = 0;
+    for (;;) {
+        bool found = ClaimChunk(state, threadIndex, &chunk);
+        // Own queue dry: steal from the others, starting at the next thread to spread contention
+        for (int k = 1; !found && k < state->threadCount; k++) {
+            found = ClaimChunk(state, (threadIndex + k) % state->threadCount, &chunk);
+        }
+        if (!found) return;
+        int begin = chunk * state->grainSize;
+        int end = begin + state->grainSize;
+        if (end > state->itemCount) end = state->itemCount;
+        state->fn(state->userData, begin, end, threadIndex);
+    }
+}
+
+static void* JobWorkerMain(void* arg) {
+    JobWorkerArgs* args = (JobWorkerArgs*)arg;
+    JobSystemState* state = args->state;
+    unsigned int seenGeneration = 0;
+
+    pthread_mutex_lock(&state->mutex);
+    for (;;) {
+        while (state->generation == seenGeneration && !state->quit) {
+            pthread_cond_wait(&state->wake, &state->mutex);
+        }
+        if (state->quit) break;
+        seenGeneration = state->generation;
+        pthread_mutex_unlock(&state->mutex);
+
+        RunChunks(state, args->threadIndex);
+        __atomic_fetch_sub(&state->activeWorkers, 1, __ATOMIC_RELEASE);
+
+        pthread_mutex_lock(&state->mutex);
+    }
+    pthread_mutex_unlock(&state->mutex);
+    return NULL;
+}
+
+JobSystem InitJobSystem(int workerCount) {
+    JobSystem jobs = {0};
+    if (workerCount <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        workerCount = (cores > 1) ? (int)cores - 1 : 0;
+    }
+    if (workerCount > JOBS_MAX_WORKERS) workerCount = JOBS_MAX_WORKERS;
+
+    JobSystemState* state = (JobSystemState*)calloc(1, sizeof(JobSystemState));
+    pthread_mutex_init(&state->mutex, NULL);
+    pthread_cond_init(&state->wake, NULL);
+    state->threadCount = 1;
+
+    for (int w = 0; w < workerCount; w++) {
+        state->workerArgs[w].state = state;
+        state->workerArgs[w].threadIndex = w + 1;
+        if (pthread_create(&state->threads[w], NULL, JobWorkerMain, &state->workerArgs[w]) != 0) {
+            printf("WARNING: Failed to start job worker %d\n", w + 1);
+            break;
+        }
+        state->threadCount++;
+    }
+
+    jobs.workerCount = state->threadCount - 1;
+    jobs.state = state;
+    printf("INFO: Job system started with %d workers\n", jobs.workerCount);
+    return jobs;
+}
+
+int GetJobThreadCount(const JobSystem* jobs) {
+    return (jobs != NULL && jobs->state != NULL) ? jobs->state->threadCount : 1;
+}
+
+void RunParallelFor(JobSystem* jobs, int itemCount, int grainSize, JobRangeFn fn, void* userData) {
+    if (itemCount <= 0) return;
+    if (grainSize < 1) grainSize = 1;
+    if (jobs == NULL || jobs->state == NULL || jobs->workerCount == 0 || itemCount <= grainSize) {
+        fn(userData, 0, itemCount, 0);
+        return;
+    }
+
+    JobSystemState* state = jobs->state;
+    int chunkCount = (itemCount + grainSize - 1) / grainSize;
+
+    pthread_mutex_lock(&state->mutex);
+    state->fn = fn;
+    state->userData = userData;
+    state->itemCount = itemCount;
+    state->grainSize = grainSize;
+    for (int t = 0; t < state->threadCount; t++) {
+        state->queues[t].next = (int)((long)chunkCount * t / state->threadCount);
+        state->queues[t].end = (int)((long)chunkCount * (t + 1) / state->threadCount);
+    }
+    state->activeWorkers = state->threadCount - 1;
+    state->generation++;
+    pthread_cond_broadcast(&state->wake);
+    pthread_mutex_unlock(&state->mutex);
+
+    RunChunks(state, 0);
+
+    // Queues are reused by the next batch, so wait until every worker has left this one
+    while (__atomic_load_n(&state->activeWorkers, __ATOMIC_ACQUIRE) > 0) {
+        sched_yield();
+    }
+}
+
+void UnloadJobSystem(JobSystem* jobs) {
+    JobSystemState* state = jobs->state;
+    if (state == NULL) return;
+    pthread_mutex_lock(&state->mutex);
+    state->quit = true;
+    pthread_cond_broadcast(&state->wake);
+    pthread_mutex_unlock(&state->mutex);
+    for (int w = 0; w < state->threadCount - 1; w++) {
+        pthread_join(state->threads[w], NULL);
+    }
+    pthread_cond_destroy(&state->wake);
+    pthread_mutex_destroy(&state->mutex);
+    free(state);
+    jobs->state = NULL;
+    jobs->workerCount = 0;
+}
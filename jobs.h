@@ -0,0 +1,32 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdbool.h>
+
+// Worker pool size: 0 = one worker per online core minus the main thread, capped at JOBS_MAX_WORKERS
+#define JOBS_DEFAULT_WORKERS 0
+#define JOBS_MAX_WORKERS 15
+
+// Process items [begin, end); threadIndex is 0 for the calling thread and 1..workerCount for workers
+typedef void (*JobRangeFn)(void* userData, int begin, int end, int threadIndex);
+
+typedef struct JobSystemState JobSystemState;
+
+// Small pthread pool; RunParallelFor splits work into grain-sized chunks, deals each thread an
+// even share up front, and lets threads that run dry steal chunks from the others.
+typedef struct {
+    int workerCount;         // Background threads (the caller of RunParallelFor also works)
+    JobSystemState* state;
+} JobSystem;
+
+JobSystem InitJobSystem(int workerCount);
+
+// Number of distinct threadIndex values a JobRangeFn can see (1 when jobs is NULL)
+int GetJobThreadCount(const JobSystem* jobs);
+
+// Run fn over [0, itemCount) and block until every chunk is done. jobs may be NULL (runs inline).
+void RunParallelFor(JobSystem* jobs, int itemCount, int grainSize, JobRangeFn fn, void* userData);
+
+void UnloadJobSystem(JobSystem* jobs);
+
+#endif // JOBS_H
@@ -3,10 +3,137 @@
 #include "props.h"
 #include "renderer.h"
 #include "lighting.h"
-#include <stdlib.h> // For rand() and srand()
+#include "jobs.h"
+#include "world.h"
+#include <stdlib.h> // For strtoul()
+#include <string.h> // For strcmp()
 #include <time.h>   // For time()
 
-int main(void) {
+// What the scene and props passes of the frame graph draw with
+typedef struct {
+    GameState* game;
+    Scene* scene;
+    Props* props;
+    Renderer* renderer;
+    WorldStreamer* world;
+    Light light;
+    FrameStats stats; // Filled once the props passes have run, for the present pass's overlay
+} FrameContext;
+
+// Pass: full-resolution environment (walls, floor) to fullResTarget
+static void ScenePass(FrameGraph* graph, void* userData) {
+    (void)graph;
+    FrameContext* frame = (FrameContext*)userData;
+    Camera3D camera = frame->game->camera;
+    BeginFullResRender(*frame->renderer);
+        BeginMode3D(camera);
+            DrawSkybox(*frame->renderer, camera);
+            // Draw scene
+            DrawScene(frame->scene, camera);
+
+            // Draw debug visualization if enabled
+            if (frame->game->showDebugBoxes) {
+                DrawSceneDebug(frame->scene);
+                DrawPropsDebug(frame->props, camera);
+            }
+        EndMode3D();
+    EndFullResRender();
+}
+
+// Pass: Hi-Z pyramid of the scene depth and its readback (props cull against last frame's readback)
+static void OcclusionPass(FrameGraph* graph, void* userData) {
+    (void)graph;
+    FrameContext* frame = (FrameContext*)userData;
+    UpdateSceneOcclusion(frame->renderer, frame->game->camera);
+}
+
+// Times the props pass, picks next frame's props scale and snapshots the overlay numbers
+static void EndPropsStage(FrameContext* frame) {
+    Renderer* renderer = frame->renderer;
+    Props* props = frame->props;
+    EndPropsPass(renderer);
+    frame->stats = (FrameStats){
+        .renderedProps = props->renderedCount,
+        .visibleProps = props->visibleCount,
+        .losTimeSliced = props->losTimeSliced,
+        .losOldestPendingMs = props->losOldestPendingMs,
+        .grassOit = props->grassOitEnabled,
+        .grassSortMs = props->grassSort.sortMs,
+        .grassFullSortMs = props->grassSort.fullSortMs,
+        .occlusionCulling = props->occlusionCulling,
+        .occludedProps = props->occludedCount,
+        .terrainNodes = frame->scene->terrainShader.id > 0 ? frame->scene->terrainNodesDrawn : 0,
+        .terrainTriangles = frame->scene->terrainNodesDrawn * TERRAIN_PATCH_QUADS * TERRAIN_PATCH_QUADS * 2,
+        .residentTiles = frame->world->residentTiles,
+        .pendingTiles = frame->world->pendingTiles,
+        .residentProps = props->residentCount,
+        .propsWidth = renderer->propsWidth,
+        .propsHeight = renderer->propsHeight,
+        .propsPassMs = renderer->propsPassMs,
+        .dynamicResolution = renderer->dynamicResolution
+    };
+}
+
+// Pass: quarter-resolution props (grass, rocks) to quarterResTarget
+static void PropsPass(FrameGraph* graph, void* userData) {
+    (void)graph;
+    FrameContext* frame = (FrameContext*)userData;
+    Renderer* renderer = frame->renderer;
+    Props* props = frame->props;
+    Camera3D camera = frame->game->camera;
+
+    // The scene pass drew with the scene's uvScale / normal map settings; rocks use their own
+    Vector2 uvScaleRocks = {PROPS_ROCK_UV_REPEAT, PROPS_ROCK_UV_REPEAT};
+    float useNormalRocks = props->rockHasNormalMap ? 1.0f : 0.0f;
+    int locUvScale = GetShaderLocation(renderer->lightingShader, "uvScale");
+    int locUseNormalMap = GetShaderLocation(renderer->lightingShader, "useNormalMap");
+    if (locUvScale >= 0) {
+        SetShaderValue(renderer->lightingShader, locUvScale, &uvScaleRocks, SHADER_UNIFORM_VEC2);
+    }
+    if (locUseNormalMap >= 0) {
+        SetShaderValue(renderer->lightingShader, locUseNormalMap, &useNormalRocks, SHADER_UNIFORM_FLOAT);
+    }
+
+    // Instanced rocks share lighting.fs and impostors mirror it, so both need the same uniforms
+    Shader rockShaders[2] = { renderer->lightingInstancedShader, props->impostorShader };
+    for (int r = 0; r < 2; r++) {
+        Shader rockShader = rockShaders[r];
+        if (rockShader.id == 0) continue;
+        Vector3 lightPos = frame->light.position;
+        Vector3 viewPos = camera.position;
+        Vector3 lightColor = ColorToVec3(frame->light.color);
+        SetShaderValue(rockShader, GetShaderLocation(rockShader, "lightPos"), &lightPos, SHADER_UNIFORM_VEC3);
+        SetShaderValue(rockShader, GetShaderLocation(rockShader, "lightColor"), &lightColor, SHADER_UNIFORM_VEC3);
+        SetShaderValue(rockShader, GetShaderLocation(rockShader, "viewPos"), &viewPos, SHADER_UNIFORM_VEC3);
+    }
+    if (renderer->lightingInstancedShader.id > 0) {
+        Shader rockShader = renderer->lightingInstancedShader;
+        SetShaderValue(rockShader, GetShaderLocation(rockShader, "uvScale"), &uvScaleRocks, SHADER_UNIFORM_VEC2);
+        SetShaderValue(rockShader, GetShaderLocation(rockShader, "useNormalMap"), &useNormalRocks, SHADER_UNIFORM_FLOAT);
+    }
+
+    BeginQuarterResRender(*renderer);
+        BeginMode3D(camera);
+            // Draw props
+            DrawProps(props, camera);
+        EndMode3D();
+    EndQuarterResRender();
+    if (!props->grassOitEnabled) EndPropsStage(frame);
+}
+
+// Pass: sort-free grass, accumulated into the OIT targets and resolved over quarterResTarget
+static void GrassOitPass(FrameGraph* graph, void* userData) {
+    (void)graph;
+    FrameContext* frame = (FrameContext*)userData;
+    BeginGrassOitRender(*frame->renderer);
+        BeginMode3D(frame->game->camera);
+            DrawPropsGrassOit(frame->props);
+        EndMode3D();
+    EndGrassOitRender(*frame->renderer);
+    EndPropsStage(frame);
+}
+
+int main(int argc, char** argv) {
     // Create a single point light above the scene
     Light light = {
         .position = (Vector3){0.0f, 6.0f, 0.0f},
@@ -51,68 +178,56 @@ int main(void) {
     float wallThickness = 0.2f;
 
     // Initialize scene
-    unsigned int terrainSeed = (unsigned int)time(NULL);
+    // World seed: first argument ("random" = the clock), else WORLD_DEFAULT_SEED. Same seed and settings
+    // reuse the baked tiles.
+    unsigned int terrainSeed = WORLD_DEFAULT_SEED;
+    if (argc > 1) {
+        terrainSeed = (strcmp(argv[1], "random") == 0) ? (unsigned int)time(NULL) : (unsigned int)strtoul(argv[1], NULL, 0);
+    }
+    printf("INFO: World seed %u (pass it as the first argument to revisit this world)\n", terrainSeed);
     Scene scene = InitScene(roomWidth, roomLength, wallHeight, wallThickness, 
                            "raw-assets/tiling_dungeon_brickwall01.png", 
                            "raw-assets/tiling_dungeon_floor01.png",
                            renderer.lightingShader,
+                           renderer.terrainShader,
                            terrainSeed);
 
-    // Define number of props to create
-    const int numGrassProps = 200000;  // 10800 grass billboards (72x original 150)
-    const int numRockProps = 40000;    // 3600 rock models (72x original 50)
-    const int totalProps = numGrassProps + numRockProps;
-    
-    // Initialize random number generator
-    srand(time(NULL));
+    // Props per streamed tile (the old 200000 grass and 40000 rocks over 64 tiles of 62.5 m)
+    const int grassPerTile = 3125;
+    const int rocksPerTile = 625;
+
+    // Worker pool for per-frame prop LOS and culling
+    JobSystem jobs = InitJobSystem(JOBS_DEFAULT_WORKERS);
     
-    // Initialize props with both grass and rock assets
+    // Initialize props with both grass and rock assets; tiles fill the pool as they stream in
     Props props = InitProps(
-        numGrassProps,
-        numRockProps,
         "raw-assets/grass01_c.png",
         "raw-assets/rock.glb",
         "raw-assets/tilingrock02_c.png",
         "raw-assets/tilingrock02_n.png",
-        renderer.lightingShader
+        renderer.lightingShader,
+        renderer.lightingInstancedShader,
+        &jobs
     );
-    
-    // Calculate usable room area (slightly inside the walls)
-    float marginFromWall = 1.0f;
-    float minX = -roomWidth/2 + marginFromWall;
-    float maxX = roomWidth/2 - marginFromWall;
-    float minZ = -roomLength/2 + marginFromWall;
-    float maxZ = roomLength/2 - marginFromWall;
-    
-    // Add grass props with random positions
-    for (int i = 0; i < numGrassProps; i++) {
-        // Generate random position within room bounds
-        float x = minX + ((float)rand() / RAND_MAX) * (maxX - minX);
-        float z = minZ + ((float)rand() / RAND_MAX) * (maxZ - minZ);
-        
-        // Create grass prop slightly above floor
-        float terrainY = GetTerrainHeightAt(scene, x, z);
-        Vector3 position = (Vector3){ x, terrainY + 0.05f, z };
-        AddBillboardProp(&props, position, i);
-    }
-    
-    // Add rock props with random positions
-    for (int i = 0; i < numRockProps; i++) {
-        // Generate random position within room bounds
-        float x = minX + ((float)rand() / RAND_MAX) * (maxX - minX);
-        float z = minZ + ((float)rand() / RAND_MAX) * (maxZ - minZ);
-        
-        float terrainY = GetTerrainHeightAt(scene, x, z);
-        Vector3 position = (Vector3){ x, terrainY + PROPS_ROCK_Y_OFFSET, z };
-        AddModelProp(&props, position, numGrassProps + i);
-    }
-    
-    // Print prop counts
-    printf("Created %d grass props and %d rock props (total: %d)\n", 
-           numGrassProps, numRockProps, totalProps);
+    props.occlusion = &renderer.hiz.buffer;
+    props.occlusionCulling = renderer.hiz.state != NULL;
+
+    // Terrain and props are generated per tile on a background thread; only the tiles around the
+    // camera are waited for, the rest of the window streams in over the first frames
+    WorldStreamer world = InitWorldStreamer(&scene, terrainSeed, grassPerTile, rocksPerTile);
+    WaitForWorldTiles(&world, &scene, &props, gameState.camera.position, WORLD_STARTUP_RADIUS);
 
     DisableCursor(); // Hide cursor for FPS controls
 
+    FrameContext frame = {
+        .game = &gameState,
+        .scene = &scene,
+        .props = &props,
+        .renderer = &renderer,
+        .world = &world,
+        .light = light
+    };
+
     SetTargetFPS(60);               // Set our game to run at 60 frames-per-second
     //--------------------------------------------------------------------------------------
 
@@ -121,17 +236,33 @@ int main(void) {
         // Update
         //----------------------------------------------------------------------------------
         UpdateCamera(&gameState.camera, CAMERA_FIRST_PERSON); // Use Raylib's first person camera
+        UpdateWorldStreaming(&world, &scene, &props, gameState.camera.position);
         float eyeHeight = 1.8f;
         float previousY = gameState.camera.position.y;
-        float terrainY = GetTerrainHeightAt(scene, gameState.camera.position.x, gameState.camera.position.z);
+        float terrainY = GetTerrainHeightAt(&scene, gameState.camera.position.x, gameState.camera.position.z);
         gameState.camera.position.y = terrainY + eyeHeight;
         gameState.camera.target.y += (gameState.camera.position.y - previousY);
 
         // Toggle debug visualization with F1 key
         if (IsKeyPressed(KEY_F1)) gameState.showDebugBoxes = !gameState.showDebugBoxes;
+
+        // Toggle time-sliced vs. full LOS updates with F2
+        if (IsKeyPressed(KEY_F2)) props.losTimeSliced = !props.losTimeSliced;
+
+        // Toggle sorted vs. weighted blended OIT grass with F3 (when both sides support it)
+        if (IsKeyPressed(KEY_F3) && renderer.grassOitTarget.id != 0 && IsGrassOitAvailable(&props)) {
+            props.grassOitEnabled = !props.grassOitEnabled;
+        }
+        if (IsKeyPressed(KEY_F4) && renderer.hiz.state != NULL) {
+            props.occlusionCulling = !props.occlusionCulling;
+        }
+        if (IsKeyPressed(KEY_F5)) SetDynamicResolution(&renderer, !renderer.dynamicResolution);
+        if (IsKeyPressed(KEY_F6)) SetFusedComposite(&renderer, !renderer.fusedComposite);
+        if (IsKeyPressed(KEY_F7)) renderer.dofEnabled = !renderer.dofEnabled;
+        if (IsKeyPressed(KEY_F8)) renderer.frameGraph.dumpNextFrame = true; // Pass order and target lifetimes to stdout
         
         // Update prop visibility based on line of sight
-        UpdatePropVisibility(&props, scene, gameState.camera);
+        UpdatePropVisibility(&props, &scene, gameState.camera);
 
         // Update light position in renderer
         renderer.lightPosition = light.position;
@@ -153,7 +284,6 @@ int main(void) {
         int locUvScale = GetShaderLocation(renderer.lightingShader, "uvScale");
         int locUseNormalMap = GetShaderLocation(renderer.lightingShader, "useNormalMap");
         Vector2 uvScaleScene = {1.0f, 1.0f};
-        Vector2 uvScaleRocks = {PROPS_ROCK_UV_REPEAT, PROPS_ROCK_UV_REPEAT};
         float useNormalScene = scene.floorHasNormalMap ? 1.0f : 0.0f;
         if (locUvScale >= 0) {
             SetShaderValue(renderer.lightingShader, locUvScale, &uvScaleScene, SHADER_UNIFORM_VEC2);
@@ -162,52 +292,61 @@ int main(void) {
             SetShaderValue(renderer.lightingShader, locUseNormalMap, &useNormalScene, SHADER_UNIFORM_FLOAT);
         }
 
+        // CDLOD terrain shares lighting.fs with the scene settings
+        if (renderer.terrainShader.id > 0) {
+            Shader terrainShader = renderer.terrainShader;
+            Vector3 lightPos = light.position;
+            Vector3 viewPos = gameState.camera.position;
+            Vector3 lightColor = ColorToVec3(light.color);
+            SetShaderValue(terrainShader, GetShaderLocation(terrainShader, "lightPos"), &lightPos, SHADER_UNIFORM_VEC3);
+            SetShaderValue(terrainShader, GetShaderLocation(terrainShader, "lightColor"), &lightColor, SHADER_UNIFORM_VEC3);
+            SetShaderValue(terrainShader, GetShaderLocation(terrainShader, "viewPos"), &viewPos, SHADER_UNIFORM_VEC3);
+            SetShaderValue(terrainShader, GetShaderLocation(terrainShader, "uvScale"), &uvScaleScene, SHADER_UNIFORM_VEC2);
+            SetShaderValue(terrainShader, GetShaderLocation(terrainShader, "useNormalMap"), &useNormalScene, SHADER_UNIFORM_FLOAT);
+        }
+
         // Example to re-enable cursor: Press ESC to exit, or another key to toggle
         // if (IsKeyPressed(KEY_ESCAPE)) EnableCursor();
 
         //----------------------------------------------------------------------------------
         // Draw
         //----------------------------------------------------------------------------------
-        // 1. Draw full-resolution environment (walls, floor) to fullResTarget
-        BeginFullResRender(renderer);
-            BeginMode3D(gameState.camera);
-                DrawSkybox(renderer, gameState.camera);
-                // Draw scene
-                DrawScene(scene);
-                
-                // Draw debug visualization if enabled
-                if (gameState.showDebugBoxes) {
-                    DrawSceneDebug(scene);
-                    DrawPropsDebug(&props, gameState.camera);
-                }
-            EndMode3D();
-        EndFullResRender();
+        // Passes are declared in order with what they read and write; the graph culls what the present
+        // pass doesn't need and pools the transient post targets
+        FrameGraph* graph = &renderer.frameGraph;
+        BeginFrameGraph(graph);
+        int sceneTarget = ImportFrameTarget(graph, "scene", renderer.fullResTarget);
+        int propsTarget = ImportFrameTarget(graph, "props", renderer.quarterResTarget);
 
-        if (locUvScale >= 0) {
-            SetShaderValue(renderer.lightingShader, locUvScale, &uvScaleRocks, SHADER_UNIFORM_VEC2);
-        }
-        float useNormalRocks = props.rockHasNormalMap ? 1.0f : 0.0f;
-        if (locUseNormalMap >= 0) {
-            SetShaderValue(renderer.lightingShader, locUseNormalMap, &useNormalRocks, SHADER_UNIFORM_FLOAT);
-        }
+        // 1. Full-resolution environment, then the Hi-Z readback of its depth
+        int pass = AddFramePass(graph, "scene", ScenePass, &frame);
+        FrameWrite(graph, pass, sceneTarget);
+        pass = AddFramePass(graph, "occlusion", OcclusionPass, &frame);
+        FrameRead(graph, pass, sceneTarget);
+        SetFramePassSideEffect(graph, pass);
 
-        // 2. Draw quarter-resolution props (grass) to quarterResTarget
-        BeginQuarterResRender(renderer);
-            BeginMode3D(gameState.camera);
-                // Draw props
-                DrawProps(&props, gameState.camera);
-            EndMode3D();
-        EndQuarterResRender();
+        // 2. Quarter-resolution props; 2b. sort-free grass resolved over them
+        pass = AddFramePass(graph, "props", PropsPass, &frame);
+        FrameWrite(graph, pass, propsTarget);
+        if (props.grassOitEnabled) {
+            int oitTarget = ImportFrameTarget(graph, "grassOit", renderer.grassOitTarget);
+            pass = AddFramePass(graph, "grassOit", GrassOitPass, &frame);
+            FrameWrite(graph, pass, oitTarget);
+            FrameWrite(graph, pass, propsTarget);
+        }
 
         // 3. Composite to screen and draw UI
-        CompositeFinalFrame(renderer, gameState.camera, props.renderedCount, props.visibleCount);
+        AddPostPasses(&renderer, sceneTarget, propsTarget, gameState.camera, &frame.stats);
+        ExecuteFrameGraph(graph);
     }
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
     // Unload resources
-    UnloadScene(scene);
+    UnloadWorldStreamer(&world); // Stops the generator before the scene it reads goes away
+    UnloadScene(&scene);
     UnloadProps(&props);
+    UnloadJobSystem(&jobs);
     UnloadRenderer(renderer);  // This now handles unloading the shader
 
     CloseWindow();                // Close window and OpenGL context
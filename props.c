@@ -3,44 +3,233 @@
 #include <string.h>
 #include "rlgl.h"   // Required for rlDisableDepthMask and rlEnableDepthMask
 
-static BoundingBox BuildDummyBounds(Vector3 position, Vector3 halfExtents) {
+#define PROP_QUANT_MAX 65535.0f     // Full range of a 16-bit quantized coordinate
+#define PROP_INSTANCE_TEXELS 3      // RGBA32F texels per prop in instanceDataTexture
+
+const PropTypeInfo PROP_TYPE_INFO[PROP_TYPE_COUNT] = {
+    [PROP_BILLBOARD] = { .dummyHalfExtents = {0.20f, 0.75f, 0.20f}, .isOccluder = false,
+                         .aoRadius = 0.20f, .aoYOffset = 0.01f, .aoAlpha = 81 },
+    [PROP_MODEL]     = { .dummyHalfExtents = {0.45f, 0.55f, 0.45f}, .isOccluder = true,
+                         .aoRadius = 0.48f, .aoYOffset = 0.02f, .aoAlpha = 195 },
+};
+
+// Dequantization constants for one grid cell
+typedef struct {
+    float baseX;
+    float baseY;
+    float baseZ;
+    float scaleXZ;
+    float scaleY;
+} PropCellDecode;
+
+static BoundingBox GetPropBounds(Vector3 position, PropType type) {
+    Vector3 halfExtents = PROP_TYPE_INFO[type].dummyHalfExtents;
     return (BoundingBox){
         .min = (Vector3){position.x - halfExtents.x, position.y - halfExtents.y, position.z - halfExtents.z},
         .max = (Vector3){position.x + halfExtents.x, position.y + halfExtents.y, position.z + halfExtents.z}
     };
 }
 
-static bool IsTerrainBlockingCheap(Scene scene, Vector3 origin, Vector3 target) {
+// Cell index of world cell (cx, cz): the owning tile's slot, then the cell within the tile
+static inline int GetPropGridCell(int cx, int cz) {
+    int tileX = WorldFloorDiv(cx, PROPS_GRID_CELLS_PER_TILE);
+    int tileZ = WorldFloorDiv(cz, PROPS_GRID_CELLS_PER_TILE);
+    int localX = cx - tileX * PROPS_GRID_CELLS_PER_TILE;
+    int localZ = cz - tileZ * PROPS_GRID_CELLS_PER_TILE;
+    return GetWorldTileSlot(tileX, tileZ) * PROPS_GRID_CELLS_PER_TILE * PROPS_GRID_CELLS_PER_TILE +
+           localZ * PROPS_GRID_CELLS_PER_TILE + localX;
+}
+
+static PropCellDecode GetPropCellDecode(const PropGrid* grid, int cell) {
+    return (PropCellDecode){
+        .baseX = grid->cellBaseX[cell],
+        .baseY = grid->cellMinY[cell],
+        .baseZ = grid->cellBaseZ[cell],
+        .scaleXZ = grid->cellSize / PROP_QUANT_MAX,
+        .scaleY = (grid->cellMaxY[cell] - grid->cellMinY[cell]) / PROP_QUANT_MAX
+    };
+}
+
+static inline Vector3 DecodePropPosition(const Props* props, PropCellDecode decode, int i) {
+    return (Vector3){
+        decode.baseX + (float)props->posX[i] * decode.scaleXZ,
+        decode.baseY + (float)props->posY[i] * decode.scaleY,
+        decode.baseZ + (float)props->posZ[i] * decode.scaleXZ
+    };
+}
+
+static unsigned short QuantizePropCoord(float value, float base, float range) {
+    if (range <= 0.0f) return 0;
+    float q = (value - base) / range * PROP_QUANT_MAX + 0.5f;
+    if (q < 0.0f) q = 0.0f;
+    if (q > PROP_QUANT_MAX) q = PROP_QUANT_MAX;
+    return (unsigned short)q;
+}
+
+static inline bool IsPropVisible(const Props* props, int i) {
+    return (props->visibleBits[i >> 5] >> (i & 31)) & 1u;
+}
+
+// Atomic because neighbouring cells evaluated on different job threads can share a bitset word
+static inline void SetPropVisible(Props* props, int i, bool visible) {
+    unsigned int mask = 1u << (i & 31);
+    if (visible) __atomic_fetch_or(&props->visibleBits[i >> 5], mask, __ATOMIC_RELAXED);
+    else __atomic_fetch_and(&props->visibleBits[i >> 5], ~mask, __ATOMIC_RELAXED);
+}
+
+static float HashToUnitFloat(unsigned int x) {
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return (float)(x & 0x00FFFFFFU) / 16777215.0f;
+}
+
+// Per-rock scale and yaw (degrees), hashed from the pool index (stable: a tile always lands in the same slot)
+static void GetRockTransform(int i, float* scale, float* yawDegrees) {
+    *scale = 0.38f + HashToUnitFloat((unsigned int)(i * 7919 + 101)) * 0.34f;
+    *yawDegrees = (float)((i * 37) % 360);
+}
+
+// Smooth yaw (Y) + pitch (X) from world XZ only so nearby grass shares similar orientation (static field).
+static void GrassFieldAngles(float x, float z, float* yaw, float* pitch) {
+    float nx = x * 0.026f + z * 0.014f;
+    float nz = z * 0.023f - x * 0.018f;
+    float a = sinf(nx) * 0.72f + sinf(nx * 0.47f + nz * 0.31f) * 0.28f;
+    float b = cosf(nz) * 0.68f + cosf(nx * 0.55f - nz * 0.42f) * 0.32f;
+    *yaw = (a * 0.92f + b * 0.55f) * PI;
+    float c = sinf(nz * 1.15f + nx * 0.74f) * 0.62f + cosf(nx * 1.08f) * 0.38f;
+    *pitch = c * (16.0f * DEG2RAD);
+}
+
+// Per-blade grass constants; the wind lean itself is animated from these at draw time
+typedef struct {
+    float yaw;
+    float pitch;
+    float speed;
+    float phase;
+    float maxLean;
+} GrassBladeParams;
+
+static GrassBladeParams GetGrassBladeParams(int i, Vector3 position) {
+    GrassBladeParams blade = { 0 };
+    GrassFieldAngles(position.x, position.z, &blade.yaw, &blade.pitch);
+    float randA = HashToUnitFloat((unsigned int)(i * 9781 + 17));
+    float randB = HashToUnitFloat((unsigned int)(i * 6271 + 53));
+    blade.speed = 0.8f + randA * 1.6f;
+    blade.phase = randB * PI * 2.0f;
+    blade.maxLean = (5.0f + randA * 11.0f) * DEG2RAD;
+    return blade;
+}
+
+// Props sit on or slightly in the ground, so the last LOS_RAY_END_TRIM meters before the target are not tested
+static bool IsTerrainBlockingRay(const Scene* scene, Vector3 origin, Vector3 target) {
     Vector3 delta = Vector3Subtract(target, origin);
-    for (int i = 1; i < LOS_TERRAIN_SAMPLES; i++) {
-        float t = (float)i / (float)LOS_TERRAIN_SAMPLES;
-        Vector3 samplePoint = Vector3Add(origin, Vector3Scale(delta, t));
-        float terrainY = GetTerrainHeightAt(scene, samplePoint.x, samplePoint.z);
-        if (terrainY > samplePoint.y + 0.15f) {
-            return true;
+    float length = Vector3Length(delta);
+    if (length <= LOS_RAY_END_TRIM) return false;
+    Vector3 end = Vector3Add(origin, Vector3Scale(delta, (length - LOS_RAY_END_TRIM) / length));
+    return IsTerrainSegmentOccluded(scene, origin, end, LOS_TERRAIN_TOLERANCE);
+}
+
+// Hemi-octahedral view direction of an atlas position in [-1, 1]^2; must match impostor.vs
+static Vector3 HemiOctDecode(float ox, float oy) {
+    float x = (ox + oy) * 0.5f;
+    float z = (ox - oy) * 0.5f;
+    return Vector3Normalize((Vector3){ x, 1.0f - fabsf(x) - fabsf(z), z });
+}
+
+// Renders the rock from PROPS_IMPOSTOR_FRAMES^2 upper-hemisphere directions into an albedo and a
+// model-space normal atlas. Each view is orthographic and framed on the model's bounding sphere, with
+// the same camera basis impostor.vs rebuilds for its cards.
+static void BakeRockImpostor(Props* props, Shader bakeShader) {
+    Model model = props->model;
+    BoundingBox box = GetModelBoundingBox(model);
+    props->impostorCenter = Vector3Scale(Vector3Add(box.min, box.max), 0.5f);
+    props->impostorRadius = Vector3Distance(box.min, box.max) * 0.5f;
+    int frames = PROPS_IMPOSTOR_FRAMES;
+    int frameSize = PROPS_IMPOSTOR_FRAME_SIZE;
+    props->impostorAlbedo = LoadRenderTexture(frames * frameSize, frames * frameSize);
+    props->impostorNormal = LoadRenderTexture(frames * frameSize, frames * frameSize);
+    SetTextureFilter(props->impostorAlbedo.texture, TEXTURE_FILTER_BILINEAR);
+    SetTextureFilter(props->impostorNormal.texture, TEXTURE_FILTER_BILINEAR);
+
+    Shader* savedShaders = (Shader*)malloc((size_t)model.materialCount * sizeof(Shader));
+    for (int m = 0; m < model.materialCount; m++) {
+        savedShaders[m] = model.materials[m].shader;
+        model.materials[m].shader = bakeShader;
+    }
+    Vector2 uvScale = { PROPS_ROCK_UV_REPEAT, PROPS_ROCK_UV_REPEAT };
+    float useNormalMap = props->rockHasNormalMap ? 1.0f : 0.0f;
+    SetShaderValue(bakeShader, GetShaderLocation(bakeShader, "uvScale"), &uvScale, SHADER_UNIFORM_VEC2);
+    SetShaderValue(bakeShader, GetShaderLocation(bakeShader, "useNormalMap"), &useNormalMap, SHADER_UNIFORM_FLOAT);
+    int bakeNormalsLoc = GetShaderLocation(bakeShader, "bakeNormals");
+
+    for (int pass = 0; pass < 2; pass++) {
+        SetShaderValue(bakeShader, bakeNormalsLoc, &pass, SHADER_UNIFORM_INT);
+        BeginTextureMode(pass == 0 ? props->impostorAlbedo : props->impostorNormal);
+        ClearBackground(BLANK);
+        for (int fy = 0; fy < frames; fy++) {
+            for (int fx = 0; fx < frames; fx++) {
+                Vector3 dir = HemiOctDecode((fx + 0.5f) / frames * 2.0f - 1.0f, (fy + 0.5f) / frames * 2.0f - 1.0f);
+                Camera3D view = { 0 };
+                view.target = props->impostorCenter;
+                view.position = Vector3Add(props->impostorCenter, Vector3Scale(dir, props->impostorRadius * 2.0f));
+                view.up = (fabsf(dir.y) > 0.999f) ? (Vector3){ 0.0f, 0.0f, -1.0f } : (Vector3){ 0.0f, 1.0f, 0.0f };
+                view.fovy = props->impostorRadius * 2.0f; // Orthographic: view height in world units
+                view.projection = CAMERA_ORTHOGRAPHIC;
+                rlViewport(fx * frameSize, fy * frameSize, frameSize, frameSize);
+                BeginMode3D(view);
+                    DrawModel(model, (Vector3){ 0.0f, 0.0f, 0.0f }, 1.0f, WHITE);
+                EndMode3D();
+            }
         }
+        EndTextureMode();
     }
-    return false;
+
+    for (int m = 0; m < model.materialCount; m++) model.materials[m].shader = savedShaders[m];
+    free(savedShaders);
+    printf("Rock impostor atlas: %dx%d views of %dpx, radius %.2f\n", frames, frames, frameSize, props->impostorRadius);
+}
+
+static GrassShader LoadGrassShader(const char* fsPath) {
+    GrassShader grass = { 0 };
+    grass.shader = LoadShader("resources/shaders/grass.vs", fsPath);
+    if (grass.shader.id == 0) return grass;
+    grass.timeLoc = GetShaderLocation(grass.shader, "time");
+    grass.instanceDataLoc = GetShaderLocation(grass.shader, "instanceData");
+    grass.instanceWidthLoc = GetShaderLocation(grass.shader, "instanceDataWidth");
+    return grass;
 }
 
-Props InitProps(int billboardCount, int modelCount, const char* billboardTexturePath, const char* modelPath, const char* modelTexturePath, const char* modelNormalMapPath, Shader lightingShader) {
+static void InitPropPool(Props* props);
+
+Props InitProps(const char* billboardTexturePath, const char* modelPath, const char* modelTexturePath, const char* modelNormalMapPath, Shader lightingShader, Shader rockInstancedShader, JobSystem* jobs) {
     Props props = {0};
-    props.rockHasNormalMap = false;
-    int totalCount = billboardCount + modelCount;
-    
-    // Allocate memory for props array
-    props.props = (Prop*)malloc(totalCount * sizeof(Prop));
-    props.count = totalCount;
-    
-    // Initialize all props as invisible initially
-    for (int i = 0; i < totalCount; i++) {
-        props.props[i].visible = false;
-        props.props[i].position = (Vector3){ 0.0f, 0.0f, 0.0f };
-        props.props[i].dummyHalfExtents = (Vector3){0.25f, 0.75f, 0.25f};
-        props.props[i].dummyBounds = BuildDummyBounds(props.props[i].position, props.props[i].dummyHalfExtents);
-        props.props[i].isOccluder = false;
+    props.jobs = jobs;
+    props.rockInstancedShader = rockInstancedShader;
+    props.grassShader = LoadGrassShader("resources/shaders/grass.fs");
+    if (props.grassShader.shader.id == 0) {
+        printf("Failed to load grass shader, grass falls back to immediate-mode quads\n");
     }
-    
+    props.grassOitShader = LoadGrassShader("resources/shaders/grass_oit.fs");
+    if (props.grassOitShader.shader.id == 0) {
+        printf("Failed to load grass OIT shader, grass is always sorted\n");
+    }
+    props.groundAoShader = LoadShader("resources/shaders/ground_ao.vs", "resources/shaders/ground_ao.fs");
+    if (props.groundAoShader.id == 0) {
+        printf("Failed to load ground AO shader, AO falls back to capped per-prop cylinders\n");
+    } else {
+        props.groundAoInstanceDataLoc = GetShaderLocation(props.groundAoShader, "instanceData");
+        props.groundAoInstanceWidthLoc = GetShaderLocation(props.groundAoShader, "instanceDataWidth");
+    }
+    if (rockInstancedShader.id > 0) {
+        props.rockMeshTransformLoc = GetShaderLocation(rockInstancedShader, "meshTransform");
+        props.rockInstanceDataLoc = GetShaderLocation(rockInstancedShader, "instanceData");
+        props.rockInstanceWidthLoc = GetShaderLocation(rockInstancedShader, "instanceDataWidth");
+    }
+    props.rockHasNormalMap = false;
+
     // Load billboard texture
     props.billboardTexture = LoadTexture(billboardTexturePath);
     if (props.billboardTexture.id == 0) {
@@ -107,136 +296,987 @@ Props InitProps(int billboardCount, int modelCount, const char* billboardTexture
     }
     ApplyTextureFilterToAllMaterialMaps(props.model, PROPS_TEXTURE_FILTER_MODE);
 
+    // Distant rocks switch to impostor cards; needs the instanced rock path for the crossfade
+    if (rockInstancedShader.id > 0 && props.model.meshCount > 0) {
+        props.rockImpostorFadeLoc = GetShaderLocation(rockInstancedShader, "impostorFade");
+        props.impostorShader = LoadShader("resources/shaders/impostor.vs", "resources/shaders/impostor.fs");
+        Shader bakeShader = LoadShader("resources/shaders/impostor_bake.vs", "resources/shaders/impostor_bake.fs");
+        if (props.impostorShader.id > 0 && bakeShader.id > 0) {
+            props.impostorShader.locs[SHADER_LOC_MAP_ALBEDO] = GetShaderLocation(props.impostorShader, "texture0");
+            props.impostorShader.locs[SHADER_LOC_MAP_NORMAL] = GetShaderLocation(props.impostorShader, "texture1");
+            props.impostorLocs[0] = GetShaderLocation(props.impostorShader, "instanceData");
+            props.impostorLocs[1] = GetShaderLocation(props.impostorShader, "instanceDataWidth");
+            props.impostorLocs[2] = GetShaderLocation(props.impostorShader, "impostorFade");
+            props.impostorLocs[3] = GetShaderLocation(props.impostorShader, "impostorBounds");
+            props.impostorLocs[4] = GetShaderLocation(props.impostorShader, "impostorFrames");
+            bakeShader.locs[SHADER_LOC_MAP_ALBEDO] = GetShaderLocation(bakeShader, "texture0");
+            bakeShader.locs[SHADER_LOC_MAP_NORMAL] = GetShaderLocation(bakeShader, "texture1");
+            BakeRockImpostor(&props, bakeShader);
+        } else {
+            printf("Failed to load impostor shaders, rocks draw as meshes at every distance\n");
+            if (props.impostorShader.id > 0) UnloadShader(props.impostorShader);
+            props.impostorShader = (Shader){ 0 };
+        }
+        if (bakeShader.id > 0) UnloadShader(bakeShader);
+    }
+
     // Initialize LOS optimization fields
     props.lastCameraPosition = (Vector3){ 0.0f, 0.0f, 0.0f };
     props.needsLOSUpdate = true;  // Force initial update
+    props.losTimeSliced = true;
+    props.losBudgetMicros = LOS_TIME_SLICE_BUDGET_US;
+    props.losOldestPendingMs = 0.0f;
     props.visibleCount = 0;
     props.renderedCount = 0;
-    
+
+    InitPropPool(&props);
     return props;
 }
 
-void AddBillboardProp(Props* props, Vector3 position, int index) {
-    if (index >= 0 && index < props->count) {
-        props->props[index].position = position;
-        props->props[index].type = PROP_BILLBOARD;
-        props->props[index].dummyHalfExtents = (Vector3){0.20f, 0.75f, 0.20f};
-        props->props[index].dummyBounds = BuildDummyBounds(position, props->props[index].dummyHalfExtents);
-        props->props[index].isOccluder = false;
-        props->props[index].visible = true;
+// In world cell coordinates, clipped to the resident window
+static PropGridRect GetPropGridRect(const PropGrid* grid, Vector3 center, float radius) {
+    PropGridRect rect = { 0, 0, -1, -1 };
+    if (grid->cellStart == NULL) return rect;
+    rect.minX = (int)floorf((center.x - radius) / grid->cellSize);
+    rect.minZ = (int)floorf((center.z - radius) / grid->cellSize);
+    rect.maxX = (int)floorf((center.x + radius) / grid->cellSize);
+    rect.maxZ = (int)floorf((center.z + radius) / grid->cellSize);
+    if (rect.minX < grid->windowX) rect.minX = grid->windowX;
+    if (rect.minZ < grid->windowZ) rect.minZ = grid->windowZ;
+    if (rect.maxX > grid->windowX + grid->cellsX - 1) rect.maxX = grid->windowX + grid->cellsX - 1;
+    if (rect.maxZ > grid->windowZ + grid->cellsZ - 1) rect.maxZ = grid->windowZ + grid->cellsZ - 1;
+    return rect;
+}
+
+static bool IsCellInRect(PropGridRect rect, int cx, int cz) {
+    return cx >= rect.minX && cx <= rect.maxX && cz >= rect.minZ && cz <= rect.maxZ;
+}
+
+// Blade quad for the grass shader: corners in blade space (bottom edge centered on the prop),
+// drawn as two triangles with backface culling off
+static void LoadGrassQuad(Props* props) {
+    float w = props->billboardSize.x;
+    float h = props->billboardSize.y;
+    Rectangle src = props->billboardSourceRec;
+    float tw = (float)props->billboardTexture.width;
+    float th = (float)props->billboardTexture.height;
+    float u0 = src.x / tw;
+    float u1 = (src.x + src.width) / tw;
+    float v0 = (src.y + src.height) / th;
+    float v1 = src.y / th;
+    float corners[6 * 3] = {
+        -w * 0.5f, 0.0f, 0.0f,   w * 0.5f, 0.0f, 0.0f,   w * 0.5f, h, 0.0f,
+        -w * 0.5f, 0.0f, 0.0f,   w * 0.5f, h, 0.0f,     -w * 0.5f, h, 0.0f,
+    };
+    float texcoords[6 * 2] = {
+        u0, v0,   u1, v0,   u1, v1,
+        u0, v0,   u1, v1,   u0, v1,
+    };
+    props->grassVao = rlLoadVertexArray();
+    rlEnableVertexArray(props->grassVao);
+    props->grassQuadVbo[0] = rlLoadVertexBuffer(corners, (int)sizeof(corners), false);
+    rlSetVertexAttribute(0, 3, RL_FLOAT, false, 0, 0); // vertexPosition
+    rlEnableVertexAttribute(0);
+    props->grassQuadVbo[1] = rlLoadVertexBuffer(texcoords, (int)sizeof(texcoords), false);
+    rlSetVertexAttribute(1, 2, RL_FLOAT, false, 0, 0); // vertexTexCoord
+    rlEnableVertexAttribute(1);
+    rlDisableVertexBuffer();
+    rlDisableVertexArray();
+}
+
+// Binds a per-instance float index stream to PROPS_INSTANCE_ATTRIB_LOCATION of a VAO
+static void AttachInstanceIndexStream(unsigned int vaoId, unsigned int vboId) {
+    if (!rlEnableVertexArray(vaoId)) return;
+    rlEnableVertexBuffer(vboId);
+    rlSetVertexAttribute(PROPS_INSTANCE_ATTRIB_LOCATION, 1, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(PROPS_INSTANCE_ATTRIB_LOCATION);
+    rlSetVertexAttributeDivisor(PROPS_INSTANCE_ATTRIB_LOCATION, 1);
+    rlDisableVertexBuffer();
+    rlDisableVertexArray();
+}
+
+// Six-vertex quad (two triangles) as vertexPosition only; instance streams are attached separately
+static unsigned int LoadQuadVertexArray(const float corners[18], unsigned int* vboId) {
+    unsigned int vaoId = rlLoadVertexArray();
+    rlEnableVertexArray(vaoId);
+    *vboId = rlLoadVertexBuffer(corners, 18 * (int)sizeof(float), false);
+    rlSetVertexAttribute(0, 3, RL_FLOAT, false, 0, 0); // vertexPosition
+    rlEnableVertexAttribute(0);
+    rlDisableVertexBuffer();
+    rlDisableVertexArray();
+    return vaoId;
+}
+
+// Per-prop constants for the float instance texture. Rock meshes, the grass quad and the AO decal quad
+// get a per-instance index attribute, so DrawProps only re-uploads which props are visible.
+//   rock:  (pos.xyz, scale), (cos yaw, sin yaw, 0, 0),                  (AO radius, y offset, strength, 0)
+//   grass: (pos.xyz, yaw),   (pitch, wind speed, wind phase, max lean), (AO radius, y offset, strength, 0)
+static void WritePropInstanceTexels(const Props* props, int i, Vector3 p, float* texel) {
+    texel[0] = p.x;
+    texel[1] = p.y;
+    texel[2] = p.z;
+    if (props->types[i] == PROP_MODEL) {
+        float scale = 1.0f;
+        float yawDegrees = 0.0f;
+        GetRockTransform(i, &scale, &yawDegrees);
+        texel[3] = scale;
+        texel[4] = cosf(yawDegrees * DEG2RAD);
+        texel[5] = sinf(yawDegrees * DEG2RAD);
+    } else {
+        GrassBladeParams blade = GetGrassBladeParams(i, p);
+        texel[3] = blade.yaw;
+        texel[4] = blade.pitch;
+        texel[5] = blade.speed;
+        texel[6] = blade.phase;
+        texel[7] = blade.maxLean;
+    }
+    const PropTypeInfo* info = &PROP_TYPE_INFO[props->types[i]];
+    texel[8] = info->aoRadius;
+    texel[9] = info->aoYOffset + 0.01f; // Top of the old 1 cm AO cylinder
+    texel[10] = (float)info->aoAlpha / 255.0f;
+}
+
+// Instance texture and index streams sized for the whole pool; tiles fill in their rows as they commit
+static void LoadPropInstanceData(Props* props) {
+    bool rocksInstanced = props->rockInstancedShader.id > 0;
+    bool grassInstanced = props->grassShader.shader.id > 0;
+    bool groundAoInstanced = props->groundAoShader.id > 0;
+    if (!rocksInstanced && !grassInstanced && !groundAoInstanced) return;
+
+    int width = PROPS_INSTANCE_TEXTURE_WIDTH;
+    int height = props->count * PROP_INSTANCE_TEXELS / width;
+    props->instanceDataTexture.id = rlLoadTexture(NULL, width, height, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1);
+    props->instanceDataTexture.width = width;
+    props->instanceDataTexture.height = height;
+    props->instanceDataTexture.mipmaps = 1;
+    props->instanceDataTexture.format = PIXELFORMAT_UNCOMPRESSED_R32G32B32A32;
+    if (props->instanceDataTexture.id == 0) {
+        printf("Failed to create prop instance data texture, props fall back to per-prop draws\n");
+        return;
+    }
+
+    if (rocksInstanced) {
+        props->rockInstanceIndices = (float*)malloc((size_t)props->count * sizeof(float));
+        props->rockInstanceVbo = rlLoadVertexBuffer(NULL, props->count * (int)sizeof(float), true);
+        for (int m = 0; m < props->model.meshCount; m++) {
+            AttachInstanceIndexStream(props->model.meshes[m].vaoId, props->rockInstanceVbo);
+        }
+    }
+    if (grassInstanced) {
+        LoadGrassQuad(props);
+        props->grassInstanceIndices = (float*)malloc((size_t)props->count * sizeof(float));
+        props->grassInstanceVbo = rlLoadVertexBuffer(NULL, props->count * (int)sizeof(float), true);
+        AttachInstanceIndexStream(props->grassVao, props->grassInstanceVbo);
+    }
+    if (groundAoInstanced) {
+        // Flat unit quad in XZ, drawn with backface culling off
+        const float corners[18] = {
+            -1.0f, 0.0f, -1.0f,   1.0f, 0.0f, -1.0f,   1.0f, 0.0f, 1.0f,
+            -1.0f, 0.0f, -1.0f,   1.0f, 0.0f, 1.0f,   -1.0f, 0.0f, 1.0f,
+        };
+        props->groundAoVao = LoadQuadVertexArray(corners, &props->groundAoQuadVbo);
+        props->groundAoInstanceIndices = (float*)malloc((size_t)props->count * sizeof(float));
+        props->groundAoInstanceVbo = rlLoadVertexBuffer(NULL, props->count * (int)sizeof(float), true);
+        AttachInstanceIndexStream(props->groundAoVao, props->groundAoInstanceVbo);
+    }
+    if (rocksInstanced && props->impostorShader.id > 0) {
+        // Card corners in [-1, 1]^2; the shader orients the card per instance
+        const float corners[18] = {
+            -1.0f, -1.0f, 0.0f,   1.0f, -1.0f, 0.0f,   1.0f, 1.0f, 0.0f,
+            -1.0f, -1.0f, 0.0f,   1.0f, 1.0f, 0.0f,   -1.0f, 1.0f, 0.0f,
+        };
+        props->impostorVao = LoadQuadVertexArray(corners, &props->impostorQuadVbo);
+        props->impostorInstanceIndices = (float*)malloc((size_t)props->count * sizeof(float));
+        props->impostorInstanceVbo = rlLoadVertexBuffer(NULL, props->count * (int)sizeof(float), true);
+        AttachInstanceIndexStream(props->impostorVao, props->impostorInstanceVbo);
+    }
+    printf("Prop instance data: %dx%d RGBA32F texture, rocks %s, grass %s, ground AO %s\n", width, height,
+           props->rockInstanceVbo != 0 ? "instanced" : "per-prop", props->grassInstanceVbo != 0 ? "instanced" : "per-prop",
+           props->groundAoInstanceVbo != 0 ? "instanced" : "per-prop");
+    if (props->impostorInstanceVbo != 0) {
+        printf("Rock impostors beyond %.0fm (%.0fm dithered crossfade)\n", PROPS_IMPOSTOR_DISTANCE, PROPS_IMPOSTOR_FADE_BAND);
+    }
+}
+
+// Pool, grid and per-frame buffers for a full resident window; every tile slot starts empty
+static void InitPropPool(Props* props) {
+    PropGrid* grid = &props->grid;
+    const int cellsPerTile = PROPS_GRID_CELLS_PER_TILE * PROPS_GRID_CELLS_PER_TILE;
+    int poolCount = TERRAIN_TILE_SLOTS * PROPS_TILE_CAPACITY;
+    int cellCount = TERRAIN_TILE_SLOTS * cellsPerTile;
+    props->count = poolCount;
+    props->residentCount = 0;
+    props->tileCounts = (int*)calloc(TERRAIN_TILE_SLOTS, sizeof(int));
+    props->posX = (unsigned short*)calloc((size_t)poolCount, sizeof(unsigned short));
+    props->posY = (unsigned short*)calloc((size_t)poolCount, sizeof(unsigned short));
+    props->posZ = (unsigned short*)calloc((size_t)poolCount, sizeof(unsigned short));
+    props->types = (unsigned char*)calloc((size_t)poolCount, 1);
+    props->visibleBits = (unsigned int*)calloc((size_t)poolCount / 32, sizeof(unsigned int));
+
+    grid->cellSize = WORLD_TILE_SIZE / (float)PROPS_GRID_CELLS_PER_TILE;
+    grid->cellsX = WORLD_WINDOW_TILES * PROPS_GRID_CELLS_PER_TILE;
+    grid->cellsZ = WORLD_WINDOW_TILES * PROPS_GRID_CELLS_PER_TILE;
+    grid->cellStart = (int*)malloc((size_t)cellCount * sizeof(int));
+    grid->cellEnd = (int*)malloc((size_t)cellCount * sizeof(int));
+    grid->cellBaseX = (float*)calloc((size_t)cellCount, sizeof(float));
+    grid->cellBaseZ = (float*)calloc((size_t)cellCount, sizeof(float));
+    grid->cellMinY = (float*)calloc((size_t)cellCount, sizeof(float));
+    grid->cellMaxY = (float*)calloc((size_t)cellCount, sizeof(float));
+    grid->viewCells = (int*)malloc((size_t)cellCount * sizeof(int));
+    grid->viewCellPassed = (int*)malloc((size_t)cellCount * sizeof(int));
+    grid->cellVisibleCount = (int*)calloc((size_t)cellCount, sizeof(int));
+    grid->cellLosTime = (double*)malloc((size_t)cellCount * sizeof(double));
+    grid->cellLosWaitStart = (double*)malloc((size_t)cellCount * sizeof(double));
+    grid->cellLosCamera = (Vector3*)calloc((size_t)cellCount, sizeof(Vector3));
+    grid->losCells = (int*)malloc((size_t)cellCount * sizeof(int));
+    grid->losCandidates = (PropLosCandidate*)malloc((size_t)cellCount * sizeof(PropLosCandidate));
+    for (int c = 0; c < cellCount; c++) {
+        int start = (c / cellsPerTile) * PROPS_TILE_CAPACITY;
+        grid->cellStart[c] = start;
+        grid->cellEnd[c] = start;
+        grid->cellLosTime[c] = -1.0;
+        grid->cellLosWaitStart[c] = -1.0;
+    }
+
+    // Per-frame culling buffers: the draw list can hold the whole pool, scratch holds a full tile in one cell
+    props->drawList.indices = (int*)malloc((size_t)poolCount * sizeof(int));
+    props->drawList.positions = (Vector3*)malloc((size_t)poolCount * sizeof(Vector3));
+    props->drawList.count = 0;
+
+    // Persistent grass sort buffers (no per-frame heap traffic)
+    GrassSortState* sort = &props->grassSort;
+    sort->keys = (unsigned int*)malloc((size_t)poolCount * sizeof(unsigned int));
+    sort->keysTemp = (unsigned int*)malloc((size_t)poolCount * sizeof(unsigned int));
+    sort->slots = (int*)malloc((size_t)poolCount * sizeof(int));
+    sort->orderA = (int*)malloc((size_t)poolCount * sizeof(int));
+    sort->orderB = (int*)malloc((size_t)poolCount * sizeof(int));
+    sort->propIndices = (int*)malloc((size_t)poolCount * sizeof(int));
+    sort->lastPropIndices = (int*)malloc((size_t)poolCount * sizeof(int));
+    sort->order = sort->orderA;
+    sort->valid = false;
+    size_t scratchCount = (size_t)PROPS_TILE_CAPACITY * (size_t)GetJobThreadCount(props->jobs);
+    props->cullScratchStride = PROPS_TILE_CAPACITY;
+    props->cullX = (float*)malloc(scratchCount * sizeof(float));
+    props->cullY = (float*)malloc(scratchCount * sizeof(float));
+    props->cullZ = (float*)malloc(scratchCount * sizeof(float));
+    props->cullSource = (int*)malloc(scratchCount * sizeof(int));
+    props->cullLocal = (int*)malloc(scratchCount * sizeof(int));
+
+    LoadPropInstanceData(props);
+
+    props->losRect = (PropGridRect){ 0, 0, -1, -1 };
+    size_t packedBytes = (size_t)poolCount * (3 * sizeof(unsigned short) + 1) + (size_t)poolCount / 32 * sizeof(unsigned int);
+    printf("Prop pool: %d tiles of %d props, %dx%d cells of %.1fm, packed in %.1f KB\n", TERRAIN_TILE_SLOTS,
+           PROPS_TILE_CAPACITY, grid->cellsX, grid->cellsZ, grid->cellSize, (double)packedBytes / 1024.0);
+}
+
+void SetPropGridWindow(Props* props, int tileX, int tileZ) {
+    props->grid.windowX = tileX * PROPS_GRID_CELLS_PER_TILE;
+    props->grid.windowZ = tileZ * PROPS_GRID_CELLS_PER_TILE;
+}
+
+static unsigned int HashPropTile(int tileX, int tileZ, unsigned int seed) {
+    unsigned int h = (unsigned int)tileX * 73856093u ^ (unsigned int)tileZ * 19349663u ^ seed * 83492791u;
+    h ^= h >> 16;
+    h *= 0x7feb352dU;
+    h ^= h >> 15;
+    return h;
+}
+
+// Relative scatter density from the surface normal: grass thins out on steep ground, rocks gather there
+static float GetScatterDensity(PropType type, float normalY) {
+    float flat = Clamp((normalY - 0.75f) / 0.20f, 0.0f, 1.0f);
+    flat = flat * flat * (3.0f - 2.0f * flat);
+    return (type == PROP_BILLBOARD) ? 0.15f + 0.85f * flat : 1.0f - 0.6f * flat;
+}
+
+// One prop type's scatter over one tile. Each chunk owns a fixed range of the output and draws from its
+// own counter-based hash stream, so the result does not depend on how chunks are spread over threads.
+typedef struct {
+    const TerrainTileData* terrain;
+    PropType type;
+    unsigned int typeSeed;
+    int phase;                   // Chunks with (cx & 1) + 2 * (cz & 1) == phase fill concurrently
+    int chunkStart[PROPS_SCATTER_CHUNKS * PROPS_SCATTER_CHUNKS + 1]; // Chunk c fills [chunkStart[c], chunkStart[c + 1])
+    float* gx;                   // Tile-sample positions, indexed like PropTileData
+    float* gz;
+    float* candidateX;           // PROPS_SCATTER_CANDIDATES darts per output slot
+    float* candidateZ;
+    Vector3* candidateNormal;
+} PropScatterJob;
+
+// Split count props over the chunks in proportion to their mean density (largest remainder, so the
+// total is exact). Ranges start at first.
+static void AllocateScatterChunks(PropScatterJob* job, int first, int count) {
+    enum { CHUNKS = PROPS_SCATTER_CHUNKS * PROPS_SCATTER_CHUNKS, PROBES = 4 };
+    const float chunkSamples = (float)WORLD_TILE_QUADS / PROPS_SCATTER_CHUNKS;
+    float gx[CHUNKS * PROBES * PROBES];
+    float gz[CHUNKS * PROBES * PROBES];
+    Vector3 normals[CHUNKS * PROBES * PROBES];
+    for (int c = 0; c < CHUNKS; c++) {
+        for (int p = 0; p < PROBES * PROBES; p++) {
+            gx[c * PROBES * PROBES + p] = ((float)(c % PROPS_SCATTER_CHUNKS) + ((float)(p % PROBES) + 0.5f) / PROBES) * chunkSamples;
+            gz[c * PROBES * PROBES + p] = ((float)(c / PROPS_SCATTER_CHUNKS) + ((float)(p / PROBES) + 0.5f) / PROBES) * chunkSamples;
+        }
+    }
+    SampleTerrainTileNormals(job->terrain, gx, gz, CHUNKS * PROBES * PROBES, normals);
+
+    float density[CHUNKS];
+    float total = 0.0f;
+    for (int c = 0; c < CHUNKS; c++) {
+        density[c] = 0.0f;
+        for (int p = 0; p < PROBES * PROBES; p++) density[c] += GetScatterDensity(job->type, normals[c * PROBES * PROBES + p].y);
+        total += density[c];
+    }
+
+    int quota[CHUNKS];
+    float remainder[CHUNKS];
+    int assigned = 0;
+    for (int c = 0; c < CHUNKS; c++) {
+        float exact = (float)count * density[c] / total;
+        quota[c] = (int)exact;
+        remainder[c] = exact - (float)quota[c];
+        assigned += quota[c];
+    }
+    for (; assigned < count; assigned++) {
+        int best = 0;
+        for (int c = 1; c < CHUNKS; c++) {
+            if (remainder[c] > remainder[best]) best = c;
+        }
+        quota[best]++;
+        remainder[best] = -1.0f;
+    }
+
+    job->chunkStart[0] = first;
+    for (int c = 0; c < CHUNKS; c++) job->chunkStart[c + 1] = job->chunkStart[c] + quota[c];
+}
+
+// Smallest squared distance from (x, z) to props [begin, end), stopping once it drops to cutoff
+static float GetNearestScatterDistanceSqr(const PropScatterJob* job, int begin, int end, float x, float z, float best, float cutoff) {
+    for (int k = begin; k < end && best > cutoff; k++) {
+        float dx = job->gx[k] - x;
+        float dz = job->gz[k] - z;
+        float d = dx * dx + dz * dz;
+        if (d < best) best = d;
+    }
+    return best;
+}
+
+// Mitchell's best candidate: each prop keeps the dart farthest from the props already placed in its
+// chunk and in finished neighbour chunks, weighted by density, which gives blue-noise spacing
+static void ScatterChunk(PropScatterJob* job, int cx, int cz) {
+    const int k = PROPS_SCATTER_CANDIDATES;
+    const float chunkSamples = (float)WORLD_TILE_QUADS / PROPS_SCATTER_CHUNKS;
+    int c = cz * PROPS_SCATTER_CHUNKS + cx;
+    int start = job->chunkStart[c];
+    int end = job->chunkStart[c + 1];
+    if (end <= start) return;
+
+    unsigned int key = HashPropTile(job->terrain->tileX * PROPS_SCATTER_CHUNKS + cx, job->terrain->tileZ * PROPS_SCATTER_CHUNKS + cz, job->typeSeed);
+    float* candidateX = job->candidateX + start * k;
+    float* candidateZ = job->candidateZ + start * k;
+    Vector3* candidateNormal = job->candidateNormal + start * k;
+    int candidates = (end - start) * k;
+    for (int n = 0; n < candidates; n++) {
+        candidateX[n] = ((float)cx + HashToUnitFloat(key + (unsigned int)n * 2u)) * chunkSamples;
+        candidateZ[n] = ((float)cz + HashToUnitFloat(key + (unsigned int)n * 2u + 1u)) * chunkSamples;
+    }
+    SampleTerrainTileNormals(job->terrain, candidateX, candidateZ, candidates, candidateNormal);
+
+    const float emptyDistance = 4.0f * chunkSamples * chunkSamples;
+    for (int i = start; i < end; i++) {
+        int best = (i - start) * k;
+        float bestScore = -1.0f;
+        for (int j = 0; j < k; j++) {
+            int n = (i - start) * k + j;
+            float x = candidateX[n];
+            float z = candidateZ[n];
+            float weight = GetScatterDensity(job->type, candidateNormal[n].y);
+            float cutoff = bestScore / weight; // At or below this distance the dart cannot win
+            float nearest = GetNearestScatterDistanceSqr(job, start, i, x, z, emptyDistance, cutoff);
+            for (int nz = cz - 1; nz <= cz + 1; nz++) {
+                for (int nx = cx - 1; nx <= cx + 1; nx++) {
+                    if (nx < 0 || nz < 0 || nx >= PROPS_SCATTER_CHUNKS || nz >= PROPS_SCATTER_CHUNKS) continue;
+                    if ((nx & 1) + 2 * (nz & 1) >= job->phase) continue; // Own phase or not filled yet
+                    float ex = fmaxf(fmaxf((float)nx * chunkSamples - x, x - (float)(nx + 1) * chunkSamples), 0.0f);
+                    float ez = fmaxf(fmaxf((float)nz * chunkSamples - z, z - (float)(nz + 1) * chunkSamples), 0.0f);
+                    if (ex * ex + ez * ez >= nearest) continue;
+                    int neighbour = nz * PROPS_SCATTER_CHUNKS + nx;
+                    nearest = GetNearestScatterDistanceSqr(job, job->chunkStart[neighbour], job->chunkStart[neighbour + 1], x, z, nearest, cutoff);
+                }
+            }
+            float score = nearest * weight;
+            if (score > bestScore) {
+                bestScore = score;
+                best = n;
+            }
+        }
+        job->gx[i] = candidateX[best];
+        job->gz[i] = candidateZ[best];
+    }
+}
+
+static void ScatterPhaseChunks(void* userData, int begin, int end, int threadIndex) {
+    (void)threadIndex;
+    PropScatterJob* job = (PropScatterJob*)userData;
+    const int half = PROPS_SCATTER_CHUNKS / 2;
+    for (int i = begin; i < end; i++) {
+        ScatterChunk(job, (i % half) * 2 + (job->phase & 1), (i / half) * 2 + (job->phase >> 1));
+    }
+}
+
+void GeneratePropTile(const TerrainTileData* terrain, int grassCount, int rockCount, unsigned int seed, JobSystem* jobs, PropTileData* out) {
+    if (grassCount + rockCount > PROPS_TILE_CAPACITY) {
+        rockCount = (rockCount < PROPS_TILE_CAPACITY) ? rockCount : PROPS_TILE_CAPACITY;
+        grassCount = PROPS_TILE_CAPACITY - rockCount;
+    }
+    out->tileX = terrain->tileX;
+    out->tileZ = terrain->tileZ;
+    out->count = 0;
+
+    float gx[PROPS_TILE_CAPACITY];
+    float gz[PROPS_TILE_CAPACITY];
+    float terrainY[PROPS_TILE_CAPACITY];
+    PropScatterJob job = { .terrain = terrain, .gx = gx, .gz = gz };
+    job.candidateX = (float*)malloc((size_t)PROPS_TILE_CAPACITY * PROPS_SCATTER_CANDIDATES * sizeof(float));
+    job.candidateZ = (float*)malloc((size_t)PROPS_TILE_CAPACITY * PROPS_SCATTER_CANDIDATES * sizeof(float));
+    job.candidateNormal = (Vector3*)malloc((size_t)PROPS_TILE_CAPACITY * PROPS_SCATTER_CANDIDATES * sizeof(Vector3));
+    if (job.candidateX == NULL || job.candidateZ == NULL || job.candidateNormal == NULL) {
+        printf("ERROR: Failed to allocate prop scatter scratch\n");
+    } else {
+        // Grass fills [0, grassCount), rocks the rest; each type spaces itself independently
+        for (int type = 0; type < PROP_TYPE_COUNT; type++) {
+            job.type = (PropType)type;
+            job.typeSeed = seed + (unsigned int)type * 0x9E3779B9u;
+            AllocateScatterChunks(&job, out->count, (type == PROP_BILLBOARD) ? grassCount : rockCount);
+            for (job.phase = 0; job.phase < 4; job.phase++) {
+                RunParallelFor(jobs, PROPS_SCATTER_CHUNKS * PROPS_SCATTER_CHUNKS / 4, 1, ScatterPhaseChunks, &job);
+            }
+            for (int k = out->count; k < job.chunkStart[PROPS_SCATTER_CHUNKS * PROPS_SCATTER_CHUNKS]; k++) {
+                out->types[k] = (unsigned char)type;
+            }
+            out->count = job.chunkStart[PROPS_SCATTER_CHUNKS * PROPS_SCATTER_CHUNKS];
+        }
+    }
+    free(job.candidateX);
+    free(job.candidateZ);
+    free(job.candidateNormal);
+
+    SampleTerrainTileHeights(terrain, gx, gz, out->count, terrainY);
+    float originX = (float)terrain->tileX * WORLD_TILE_SIZE;
+    float originZ = (float)terrain->tileZ * WORLD_TILE_SIZE;
+    for (int k = 0; k < out->count; k++) {
+        bool grass = out->types[k] == PROP_BILLBOARD;
+        out->positions[k] = (Vector3){
+            originX + gx[k] * WORLD_CELL_SIZE,
+            terrainY[k] + (grass ? 0.05f : PROPS_ROCK_Y_OFFSET),
+            originZ + gz[k] * WORLD_CELL_SIZE
+        };
     }
 }
 
-void AddModelProp(Props* props, Vector3 position, int index) {
-    if (index >= 0 && index < props->count) {
-        props->props[index].position = position;
-        props->props[index].type = PROP_MODEL;
-        props->props[index].dummyHalfExtents = (Vector3){0.45f, 0.55f, 0.45f};
-        props->props[index].dummyBounds = BuildDummyBounds(position, props->props[index].dummyHalfExtents);
-        props->props[index].isOccluder = true;
-        props->props[index].visible = true;
+// Empties the slot's cells and drops their LOS state; the pool range itself is left as is
+static void ClearPropTileSlot(Props* props, int slot) {
+    PropGrid* grid = &props->grid;
+    const int cellsPerTile = PROPS_GRID_CELLS_PER_TILE * PROPS_GRID_CELLS_PER_TILE;
+    int start = slot * PROPS_TILE_CAPACITY;
+    for (int c = slot * cellsPerTile; c < (slot + 1) * cellsPerTile; c++) {
+        grid->cellStart[c] = start;
+        grid->cellEnd[c] = start;
+        grid->cellVisibleCount[c] = 0;
+        grid->cellLosTime[c] = -1.0;
+        grid->cellLosWaitStart[c] = -1.0;
     }
+    memset(props->visibleBits + start / 32, 0, PROPS_TILE_CAPACITY / 32 * sizeof(unsigned int));
+    props->residentCount -= props->tileCounts[slot];
+    props->tileCounts[slot] = 0;
+}
+
+void EvictPropTile(Props* props, int slot) {
+    ClearPropTileSlot(props, slot);
 }
 
-void UpdatePropVisibility(Props* props, Scene scene, Camera3D camera) {
-    (void)scene;
+void CommitPropTile(Props* props, const PropTileData* tile) {
+    PropGrid* grid = &props->grid;
+    const int cellsPerTile = PROPS_GRID_CELLS_PER_TILE * PROPS_GRID_CELLS_PER_TILE;
+    int slot = GetWorldTileSlot(tile->tileX, tile->tileZ);
+    int firstCell = slot * cellsPerTile;
+    int start = slot * PROPS_TILE_CAPACITY;
+    ClearPropTileSlot(props, slot);
+
+    // Counting sort into the tile's cells: histogram, prefix sum, then scatter into the pool
+    float originX = (float)tile->tileX * WORLD_TILE_SIZE;
+    float originZ = (float)tile->tileZ * WORLD_TILE_SIZE;
+    int propCell[PROPS_TILE_CAPACITY];
+    int cellCounts[PROPS_GRID_CELLS_PER_TILE * PROPS_GRID_CELLS_PER_TILE] = { 0 };
+    for (int k = 0; k < tile->count; k++) {
+        int cx = (int)floorf((tile->positions[k].x - originX) / grid->cellSize);
+        int cz = (int)floorf((tile->positions[k].z - originZ) / grid->cellSize);
+        cx = (cx < 0) ? 0 : (cx >= PROPS_GRID_CELLS_PER_TILE ? PROPS_GRID_CELLS_PER_TILE - 1 : cx);
+        cz = (cz < 0) ? 0 : (cz >= PROPS_GRID_CELLS_PER_TILE ? PROPS_GRID_CELLS_PER_TILE - 1 : cz);
+        propCell[k] = cz * PROPS_GRID_CELLS_PER_TILE + cx;
+        cellCounts[propCell[k]]++;
+    }
+    int cursor[PROPS_GRID_CELLS_PER_TILE * PROPS_GRID_CELLS_PER_TILE];
+    int offset = start;
+    for (int local = 0; local < cellsPerTile; local++) {
+        int c = firstCell + local;
+        grid->cellStart[c] = offset;
+        offset += cellCounts[local];
+        grid->cellEnd[c] = offset;
+        cursor[local] = grid->cellStart[c];
+        grid->cellBaseX[c] = originX + (float)(local % PROPS_GRID_CELLS_PER_TILE) * grid->cellSize;
+        grid->cellBaseZ[c] = originZ + (float)(local / PROPS_GRID_CELLS_PER_TILE) * grid->cellSize;
+        grid->cellMinY[c] = INFINITY;
+        grid->cellMaxY[c] = -INFINITY;
+    }
+
+    // Per-cell height span first: it is the quantization range for Y
+    for (int k = 0; k < tile->count; k++) {
+        int c = firstCell + propCell[k];
+        grid->cellMinY[c] = fminf(grid->cellMinY[c], tile->positions[k].y);
+        grid->cellMaxY[c] = fmaxf(grid->cellMaxY[c], tile->positions[k].y);
+    }
+    for (int local = 0; local < cellsPerTile; local++) {
+        int c = firstCell + local;
+        if (cellCounts[local] > 0) continue;
+        grid->cellMinY[c] = 0.0f;
+        grid->cellMaxY[c] = 0.0f;
+    }
+
+    for (int k = 0; k < tile->count; k++) {
+        int c = firstCell + propCell[k];
+        PropCellDecode decode = GetPropCellDecode(grid, c);
+        Vector3 p = tile->positions[k];
+        int dst = cursor[propCell[k]]++;
+        props->posX[dst] = QuantizePropCoord(p.x, decode.baseX, grid->cellSize);
+        props->posY[dst] = QuantizePropCoord(p.y, decode.baseY, grid->cellMaxY[c] - grid->cellMinY[c]);
+        props->posZ[dst] = QuantizePropCoord(p.z, decode.baseZ, grid->cellSize);
+        props->types[dst] = tile->types[k];
+    }
+    props->tileCounts[slot] = tile->count;
+    props->residentCount += tile->count;
+
+    // The tile owns whole rows of the instance texture, so one sub-image upload covers it
+    if (props->instanceDataTexture.id > 0) {
+        int width = props->instanceDataTexture.width;
+        int rows = PROPS_TILE_CAPACITY * PROP_INSTANCE_TEXELS / width;
+        float* texels = (float*)calloc((size_t)width * (size_t)rows * 4, sizeof(float));
+        for (int local = 0; local < cellsPerTile; local++) {
+            int c = firstCell + local;
+            PropCellDecode decode = GetPropCellDecode(grid, c);
+            for (int i = grid->cellStart[c]; i < grid->cellEnd[c]; i++) {
+                WritePropInstanceTexels(props, i, DecodePropPosition(props, decode, i),
+                                        &texels[(size_t)(i - start) * PROP_INSTANCE_TEXELS * 4]);
+            }
+        }
+        rlUpdateTexture(props->instanceDataTexture.id, 0, start * PROP_INSTANCE_TEXELS / width, width, rows,
+                        PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, texels);
+        free(texels);
+    }
+
+    // Time-sliced LOS picks new cells up first by itself (they have never been evaluated)
+    if (!props->losTimeSliced) props->needsLOSUpdate = true;
+    props->grassSort.valid = false;
+}
+
+typedef struct {
+    Props* props;
+    const Scene* scene;
+    Vector3 cameraPosition;
+    double now;
+    const int* cells;            // Cells to evaluate (items index this list)
+} PropLosJob;
+
+// LOS for a range of cells; each cell is owned by one thread, so its bookkeeping needs no atomics
+static void RunPropLosJob(void* userData, int begin, int end, int threadIndex) {
+    (void)threadIndex;
+    PropLosJob* job = (PropLosJob*)userData;
+    Props* props = job->props;
+    PropGrid* grid = &props->grid;
+
+    for (int item = begin; item < end; item++) {
+        int c = job->cells[item];
+        PropCellDecode decode = GetPropCellDecode(grid, c);
+        int visibleCount = 0;
+        for (int i = grid->cellStart[c]; i < grid->cellEnd[c]; i++) {
+            SetPropVisible(props, i, false);
+
+            Vector3 position = DecodePropPosition(props, decode, i);
+            float maxDistance = (props->types[i] == PROP_MODEL) ? LOS_MAX_ROCK_DISTANCE : LOS_MAX_GRASS_DISTANCE;
+            float distance = Vector3Distance(job->cameraPosition, position);
+            if (distance > maxDistance) continue;
+            
+            if (IsTerrainBlockingRay(job->scene, job->cameraPosition, position)) continue;
+
+            SetPropVisible(props, i, true);
+            visibleCount++;
+        }
+        grid->cellVisibleCount[c] = visibleCount;
+        grid->cellLosTime[c] = job->now;
+        grid->cellLosCamera[c] = job->cameraPosition;
+    }
+}
+
+static int CompareLosCandidates(const void* a, const void* b) {
+    float pa = ((const PropLosCandidate*)a)->priority;
+    float pb = ((const PropLosCandidate*)b)->priority;
+    if (pa > pb) return -1;
+    if (pa < pb) return 1;
+    return 0;
+}
+
+// Cells whose last LOS pass was taken from a camera position at least LOS_MIN_CAMERA_MOVE away are
+// queued. Priority grows with how far the ray direction to the cell has swung since then, with
+// staleness, and for cells ahead of the camera; it falls off with distance.
+static int BuildLosCandidates(Props* props, PropGridRect rect, Camera3D camera, double now, PropLosCandidate* out) {
+    const PropGrid* grid = &props->grid;
+    Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+    int count = 0;
+    for (int cz = rect.minZ; cz <= rect.maxZ; cz++) {
+        for (int cx = rect.minX; cx <= rect.maxX; cx++) {
+            int c = GetPropGridCell(cx, cz);
+            if (grid->cellStart[c] == grid->cellEnd[c]) continue;
+            if (grid->cellLosTime[c] < 0.0) {
+                out[count++] = (PropLosCandidate){ c, INFINITY }; // never evaluated since entering range
+                continue;
+            }
+            if (Vector3Distance(camera.position, grid->cellLosCamera[c]) < LOS_MIN_CAMERA_MOVE) continue;
+
+            Vector3 center = {
+                grid->cellBaseX[c] + 0.5f * grid->cellSize,
+                (grid->cellMinY[c] + grid->cellMaxY[c]) * 0.5f,
+                grid->cellBaseZ[c] + 0.5f * grid->cellSize
+            };
+            Vector3 toCellNow = Vector3Subtract(center, camera.position);
+            Vector3 toCellThen = Vector3Subtract(center, grid->cellLosCamera[c]);
+            float distance = Vector3Length(toCellNow);
+            float swing = 1.0f - Vector3DotProduct(Vector3Normalize(toCellNow), Vector3Normalize(toCellThen));
+            float facing = fmaxf(Vector3DotProduct(forward, Vector3Scale(toCellNow, 1.0f / fmaxf(distance, 0.001f))), 0.0f);
+            float staleness = (float)(now - grid->cellLosTime[c]);
+            float priority = (swing * 100.0f + staleness) * (1.0f + facing) / (1.0f + distance / grid->cellSize);
+            out[count++] = (PropLosCandidate){ c, priority };
+        }
+    }
+    return count;
+}
+
+void UpdatePropVisibility(Props* props, const Scene* scene, Camera3D camera) {
+    PropGrid* grid = &props->grid;
+    if (grid->cellStart == NULL) return;
+
+    double startTime = GetTime();
+    float maxRange = fmaxf(LOS_MAX_ROCK_DISTANCE, LOS_MAX_GRASS_DISTANCE);
+    PropGridRect rect = GetPropGridRect(grid, camera.position, maxRange);
+
+    // Cells that left the view radius keep stale flags otherwise; re-entering forces a fresh pass
+    PropGridRect prev = props->losRect;
+    for (int cz = prev.minZ; cz <= prev.maxZ; cz++) {
+        for (int cx = prev.minX; cx <= prev.maxX; cx++) {
+            if (IsCellInRect(rect, cx, cz)) continue;
+            int c = GetPropGridCell(cx, cz);
+            for (int i = grid->cellStart[c]; i < grid->cellEnd[c]; i++) SetPropVisible(props, i, false);
+            grid->cellVisibleCount[c] = 0;
+            grid->cellLosTime[c] = -1.0;
+            grid->cellLosWaitStart[c] = -1.0;
+        }
+    }
+    props->losRect = rect;
+
+    PropLosJob job = {
+        .props = props,
+        .scene = scene,
+        .cameraPosition = camera.position,
+        .now = startTime,
+        .cells = grid->losCells
+    };
+
     float cameraMoveDistance = Vector3Distance(camera.position, props->lastCameraPosition);
-    bool shouldUpdate = props->needsLOSUpdate || (cameraMoveDistance >= LOS_MIN_CAMERA_MOVE);
-    
-    if (!shouldUpdate) return;
-    
-    props->lastCameraPosition = camera.position;
-    props->needsLOSUpdate = false;
-    
-    int visibleCount = 0;
-    int totalCount = 0;
-    
-    for (int i = 0; i < props->count; i++) {
-        // Skip inactive props (position at origin)
-        if (props->props[i].position.x == 0 && 
-            props->props[i].position.y == 0 && 
-            props->props[i].position.z == 0) continue;
-        
-        totalCount++;
-        
-        float maxDistance = (props->props[i].type == PROP_MODEL) ? LOS_MAX_ROCK_DISTANCE : LOS_MAX_GRASS_DISTANCE;
-        float distance = Vector3Distance(camera.position, props->props[i].position);
-        if (distance > maxDistance) {
-            props->props[i].visible = false;
-            continue;
+    bool fullUpdate = props->needsLOSUpdate || (!props->losTimeSliced && cameraMoveDistance >= LOS_MIN_CAMERA_MOVE);
+    if (fullUpdate) {
+        props->lastCameraPosition = camera.position;
+        props->needsLOSUpdate = false;
+        int cellCount = 0;
+        for (int cz = rect.minZ; cz <= rect.maxZ; cz++) {
+            for (int cx = rect.minX; cx <= rect.maxX; cx++) grid->losCells[cellCount++] = GetPropGridCell(cx, cz);
         }
-        
-        props->props[i].visible = true;
-        if (IsTerrainBlockingCheap(scene, camera.position, props->props[i].position)) {
-            props->props[i].visible = false;
-            continue;
+        RunParallelFor(props->jobs, cellCount, PROPS_JOB_CELL_GRAIN, RunPropLosJob, &job);
+    } else if (props->losTimeSliced) {
+        // Most urgent cells first, in thread-pool sized batches, until the frame budget is spent
+        int candidateCount = BuildLosCandidates(props, rect, camera, startTime, grid->losCandidates);
+        qsort(grid->losCandidates, candidateCount, sizeof(PropLosCandidate), CompareLosCandidates);
+        for (int k = 0; k < candidateCount; k++) grid->losCells[k] = grid->losCandidates[k].cell;
+
+        int batchSize = GetJobThreadCount(props->jobs) * PROPS_JOB_CELL_GRAIN;
+        double budgetSeconds = (double)props->losBudgetMicros * 1e-6;
+        for (int done = 0; done < candidateCount; done += batchSize) {
+            int count = (candidateCount - done < batchSize) ? candidateCount - done : batchSize;
+            job.cells = grid->losCells + done;
+            RunParallelFor(props->jobs, count, PROPS_JOB_CELL_GRAIN, RunPropLosJob, &job);
+            if (GetTime() - startTime >= budgetSeconds) break;
+        }
+        props->lastCameraPosition = camera.position;
+    }
+
+    // Totals and staleness over the current rect: the oldest entry still waiting for a re-check.
+    // Never-evaluated cells (streamed in or back in range) age from when they were first seen here.
+    int visibleCount = 0;
+    double oldestPending = 0.0;
+    for (int cz = rect.minZ; cz <= rect.maxZ; cz++) {
+        for (int cx = rect.minX; cx <= rect.maxX; cx++) {
+            int c = GetPropGridCell(cx, cz);
+            visibleCount += grid->cellVisibleCount[c];
+            if (grid->cellStart[c] == grid->cellEnd[c]) continue;
+            bool pending = grid->cellLosTime[c] < 0.0 ||
+                           Vector3Distance(camera.position, grid->cellLosCamera[c]) >= LOS_MIN_CAMERA_MOVE;
+            if (!pending) continue;
+            double age;
+            if (grid->cellLosTime[c] < 0.0) {
+                if (grid->cellLosWaitStart[c] < 0.0) grid->cellLosWaitStart[c] = startTime;
+                age = startTime - grid->cellLosWaitStart[c];
+            } else {
+                age = startTime - grid->cellLosTime[c];
+            }
+            if (age > oldestPending) oldestPending = age;
         }
-        visibleCount++;
     }
     
     // Store the visible count
     props->visibleCount = visibleCount;
-    
+    props->losOldestPendingMs = (float)(oldestPending * 1000.0);
 }
 
-// Helper function to check if a point is inside the camera frustum
-bool IsPointInFrustum(Vector3 point, Camera3D camera, float margin) {
-    // Convert point to view space
-    Matrix viewMatrix = MatrixLookAt(camera.position, camera.target, camera.up);
-    Vector3 viewSpacePoint = Vector3Transform(point, viewMatrix);
-    
-    // Early discard points behind the camera
-    if (viewSpacePoint.z > 0) return false;
-    
-    // Calculate frustum boundaries at the point's depth
-    float aspect = (float)GetScreenWidth() / (float)GetScreenHeight();
-    float nearPlaneHeight = 2.0f * fabsf(viewSpacePoint.z) * tanf(camera.fovy * 0.5f * DEG2RAD);
-    float nearPlaneWidth = nearPlaneHeight * aspect;
-    
-    // Add margin to frustum boundaries
-    nearPlaneWidth += margin;
-    nearPlaneHeight += margin;
-    
-    // Check if point is within frustum boundaries
-    return (fabsf(viewSpacePoint.x) < nearPlaneWidth * 0.5f) && 
-           (fabsf(viewSpacePoint.y) < nearPlaneHeight * 0.5f);
+static int CompareCells(const void* a, const void* b) {
+    return *(const int*)a - *(const int*)b;
+}
+
+// Collect grid cells within the view radius whose bounds touch the frustum; returns cell count.
+// Sorted by cell index, which for tile-major cells is also pool order.
+static int CollectViewCells(Props* props, const Frustum* frustum, Vector3 cameraPosition, float radius) {
+    PropGrid* grid = &props->grid;
+    PropGridRect rect = GetPropGridRect(grid, cameraPosition, radius);
+    float halfCell = grid->cellSize * 0.5f;
+    int count = 0;
+    for (int cz = rect.minZ; cz <= rect.maxZ; cz++) {
+        for (int cx = rect.minX; cx <= rect.maxX; cx++) {
+            int c = GetPropGridCell(cx, cz);
+            if (grid->cellStart[c] == grid->cellEnd[c]) continue;
+            float minY = grid->cellMinY[c];
+            float maxY = grid->cellMaxY[c] + PROPS_GRID_PROP_HEIGHT;
+            Vector3 center = {
+                grid->cellBaseX[c] + 0.5f * grid->cellSize,
+                (minY + maxY) * 0.5f,
+                grid->cellBaseZ[c] + 0.5f * grid->cellSize
+            };
+            float halfY = (maxY - minY) * 0.5f;
+            float cellRadius = sqrtf(2.0f * halfCell * halfCell + halfY * halfY);
+            if (!IsSphereInFrustum(frustum, center, cellRadius)) continue;
+            grid->viewCells[count++] = c;
+        }
+    }
+    qsort(grid->viewCells, count, sizeof(int), CompareCells);
+    return count;
 }
 
-// Structure to store billboard data for depth sorting
 typedef struct {
-    int index;          // Original index in props array
-    float distance;     // Distance from camera
-} BillboardDepthInfo;
-
-// Comparison function for qsort (sort from far to near)
-int CompareBillboardDepth(const void* a, const void* b) {
-    BillboardDepthInfo* billboardA = (BillboardDepthInfo*)a;
-    BillboardDepthInfo* billboardB = (BillboardDepthInfo*)b;
-    
-    // Sort from far to near (descending order)
-    if (billboardA->distance > billboardB->distance) return -1;
-    if (billboardA->distance < billboardB->distance) return 1;
-    return 0;
+    Props* props;
+    const Frustum* frustum;
+    const HiZBuffer* occlusion; // NULL when occlusion culling is off or no readback has landed yet
+} PropCullJob;
+
+// Cull a range of view cells. Results land in the draw list at the cell's own prop range
+// [cellStart[c], ...), so threads never overlap and BuildPropDrawList compacts afterwards.
+// With occlusion on, a cell hidden as a whole drops all its props after the frustum test (which keeps
+// the occluded count comparable with the frustum-culled one); surviving rocks are then tested one by
+// one (grass is small and dense enough that the cell test catches nearly all of it).
+static void RunPropCullJob(void* userData, int begin, int end, int threadIndex) {
+    PropCullJob* job = (PropCullJob*)userData;
+    Props* props = job->props;
+    PropGrid* grid = &props->grid;
+    PropDrawList* list = &props->drawList;
+    size_t scratchOffset = (size_t)threadIndex * (size_t)props->cullScratchStride;
+    float* cullX = props->cullX + scratchOffset;
+    float* cullY = props->cullY + scratchOffset;
+    float* cullZ = props->cullZ + scratchOffset;
+    int* cullSource = props->cullSource + scratchOffset;
+    int* cullLocal = props->cullLocal + scratchOffset;
+    int occluded = 0;
+
+    for (int vc = begin; vc < end; vc++) {
+        int c = grid->viewCells[vc];
+        int start = grid->cellStart[c];
+        bool cellOccluded = false;
+        if (job->occlusion != NULL) {
+            // Props are binned by base position but their bounds reach past it (tilted rocks, decals on
+            // slopes), so the cell box gets the largest prop extent as slack on every side
+            const float slack = PROPS_GRID_PROP_HEIGHT;
+            BoundingBox cellBounds = {
+                .min = { grid->cellBaseX[c] - slack, grid->cellMinY[c] - slack, grid->cellBaseZ[c] - slack },
+                .max = { grid->cellBaseX[c] + grid->cellSize + slack, grid->cellMaxY[c] + slack,
+                         grid->cellBaseZ[c] + grid->cellSize + slack }
+            };
+            cellOccluded = IsBoxOccludedHiZ(job->occlusion, cellBounds);
+        }
+
+        PropCellDecode decode = GetPropCellDecode(grid, c);
+        int gathered = 0;
+        for (int i = start; i < grid->cellEnd[c]; i++) {
+            if (!IsPropVisible(props, i)) continue;
+            cullX[gathered] = decode.baseX + (float)props->posX[i] * decode.scaleXZ;
+            cullY[gathered] = decode.baseY + (float)props->posY[i] * decode.scaleY;
+            cullZ[gathered] = decode.baseZ + (float)props->posZ[i] * decode.scaleXZ;
+            cullSource[gathered] = i;
+            gathered++;
+        }
+        // Margin keeps props whose proxy straddles a plane from popping at the frustum edges
+        int passed = CullPointsFrustum(job->frustum, cullX, cullY, cullZ, gathered, PROPS_FRUSTUM_MARGIN, cullLocal);
+        if (cellOccluded) {
+            // Only props the frustum kept count as occluded, matching the per-prop rock test below
+            occluded += passed;
+            grid->viewCellPassed[vc] = 0;
+            continue;
+        }
+        int kept = 0;
+        for (int k = 0; k < passed; k++) {
+            int local = cullLocal[k];
+            int propIndex = cullSource[local];
+            Vector3 position = { cullX[local], cullY[local], cullZ[local] };
+            if (job->occlusion != NULL && props->types[propIndex] == PROP_MODEL &&
+                IsBoxOccludedHiZ(job->occlusion, GetPropBounds(position, PROP_MODEL))) {
+                occluded++;
+                continue;
+            }
+            list->indices[start + kept] = propIndex;
+            list->positions[start + kept] = position;
+            kept++;
+        }
+        grid->viewCellPassed[vc] = kept;
+    }
+    if (occluded > 0) __atomic_fetch_add(&props->occludedCount, occluded, __ATOMIC_RELAXED);
 }
 
-static float HashToUnitFloat(unsigned int x) {
-    x ^= x >> 16;
-    x *= 0x7feb352dU;
-    x ^= x >> 15;
-    x *= 0x846ca68bU;
-    x ^= x >> 16;
-    return (float)(x & 0x00FFFFFFU) / 16777215.0f;
+// Fill props->drawList with LOS-visible props inside the frustum. Frustum planes are extracted once;
+// each view cell's visible props are decoded into SoA scratch and tested in SIMD batches.
+static void BuildPropDrawList(Props* props, Camera3D camera) {
+    PropDrawList* list = &props->drawList;
+    list->count = 0;
+
+    float aspect = (float)GetScreenWidth() / (float)GetScreenHeight();
+    Frustum frustum = ExtractCameraFrustum(camera, aspect);
+    const PropGrid* grid = &props->grid;
+    int viewCellCount = CollectViewCells(props, &frustum, camera.position, fmaxf(LOS_MAX_ROCK_DISTANCE, LOS_MAX_GRASS_DISTANCE));
+
+    bool useOcclusion = props->occlusionCulling && props->occlusion != NULL && props->occlusion->valid;
+    PropCullJob job = { .props = props, .frustum = &frustum, .occlusion = useOcclusion ? props->occlusion : NULL };
+    props->occludedCount = 0;
+    RunParallelFor(props->jobs, viewCellCount, PROPS_JOB_CELL_GRAIN, RunPropCullJob, &job);
+
+    // View cells are in ascending cell order, so the compacted write cursor never passes a cell's slot
+    for (int vc = 0; vc < viewCellCount; vc++) {
+        int start = grid->cellStart[grid->viewCells[vc]];
+        int passed = grid->viewCellPassed[vc];
+        if (passed > 0 && list->count != start) {
+            memmove(list->indices + list->count, list->indices + start, (size_t)passed * sizeof(int));
+            memmove(list->positions + list->count, list->positions + start, (size_t)passed * sizeof(Vector3));
+        }
+        list->count += passed;
+    }
 }
 
-// Smooth yaw (Y) + pitch (X) from world XZ only so nearby grass shares similar orientation (static field).
-static void GrassFieldAngles(float x, float z, float* yaw, float* pitch) {
-    float nx = x * 0.026f + z * 0.014f;
-    float nz = z * 0.023f - x * 0.018f;
-    float a = sinf(nx) * 0.72f + sinf(nx * 0.47f + nz * 0.31f) * 0.28f;
-    float b = cosf(nz) * 0.68f + cosf(nx * 0.55f - nz * 0.42f) * 0.32f;
-    *yaw = (a * 0.92f + b * 0.55f) * PI;
-    float c = sinf(nz * 1.15f + nx * 0.74f) * 0.62f + cosf(nx * 1.08f) * 0.38f;
-    *pitch = c * (16.0f * DEG2RAD);
+#define GRASS_SORT_RADIX_BITS 11
+#define GRASS_SORT_RADIX_SIZE (1 << GRASS_SORT_RADIX_BITS)
+
+// Squared distance is non-negative, so its IEEE bits order like the value; invert for far-to-near
+static inline unsigned int GrassDepthKey(Vector3 cameraPosition, Vector3 position) {
+    float d = Vector3DistanceSqr(cameraPosition, position);
+    unsigned int bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return ~bits;
+}
+
+// Stable LSD radix sort (3 x 11-bit digits) of keys/values; ping-pongs through the temp buffers.
+// Returns whichever buffer ends up holding the sorted values.
+static int* RadixSortGrass(unsigned int* keys, int* values, unsigned int* keysTemp, int* valuesTemp, int count) {
+    unsigned int histogram[GRASS_SORT_RADIX_SIZE];
+    for (int shift = 0; shift < 32; shift += GRASS_SORT_RADIX_BITS) {
+        memset(histogram, 0, sizeof(histogram));
+        for (int i = 0; i < count; i++) histogram[(keys[i] >> shift) & (GRASS_SORT_RADIX_SIZE - 1)]++;
+        unsigned int sum = 0;
+        for (int b = 0; b < GRASS_SORT_RADIX_SIZE; b++) {
+            unsigned int n = histogram[b];
+            histogram[b] = sum;
+            sum += n;
+        }
+        for (int i = 0; i < count; i++) {
+            unsigned int dst = histogram[(keys[i] >> shift) & (GRASS_SORT_RADIX_SIZE - 1)]++;
+            keysTemp[dst] = keys[i];
+            valuesTemp[dst] = values[i];
+        }
+        unsigned int* k = keys; keys = keysTemp; keysTemp = k;
+        int* v = values; values = valuesTemp; valuesTemp = v;
+    }
+    return values;
+}
+
+// Collect the draw list's grass into grassSort.slots / propIndices; returns the count
+static int GatherVisibleGrass(Props* props) {
+    GrassSortState* sort = &props->grassSort;
+    const PropDrawList* list = &props->drawList;
+    int count = 0;
+    for (int k = 0; k < list->count; k++) {
+        if (props->types[list->indices[k]] != PROP_BILLBOARD) continue;
+        sort->slots[count] = k;
+        sort->propIndices[count] = list->indices[k];
+        count++;
+    }
+    return count;
+}
+
+// Key build + radix sort of the gathered grass into sort->order; returns its time in ms
+static float SortGrassKeys(GrassSortState* sort, const PropDrawList* list, Vector3 cameraPosition, int count) {
+    double startTime = GetTime();
+    for (int n = 0; n < count; n++) {
+        sort->keys[n] = GrassDepthKey(cameraPosition, list->positions[sort->slots[n]]);
+        sort->orderA[n] = n;
+    }
+    sort->order = RadixSortGrass(sort->keys, sort->orderA, sort->keysTemp, sort->orderB, count);
+    return (float)((GetTime() - startTime) * 1000.0);
+}
+
+// Order this frame's grass far to near: props->grassSort.order[n] indexes grassSort.slots, which maps
+// to draw-list slots. The sort is skipped when the camera hasn't moved and the same grass (in the same
+// relative order) is visible as last frame.
+static void SortVisibleGrass(Props* props, Vector3 cameraPosition) {
+    GrassSortState* sort = &props->grassSort;
+    double startTime = GetTime();
+
+    int count = GatherVisibleGrass(props);
+    bool unchanged = sort->valid && count == sort->lastCount &&
+                     Vector3Equals(cameraPosition, sort->lastCamera) &&
+                     memcmp(sort->propIndices, sort->lastPropIndices, (size_t)count * sizeof(int)) == 0;
+    if (!unchanged) {
+        sort->fullSortMs = SortGrassKeys(sort, &props->drawList, cameraPosition, count);
+        int* swap = sort->lastPropIndices;
+        sort->lastPropIndices = sort->propIndices;
+        sort->propIndices = swap;
+        sort->lastCount = count;
+        sort->lastCamera = cameraPosition;
+        sort->valid = true;
+    }
+    sort->count = count;
+    sort->skipped = unchanged;
+    sort->sortMs = (float)((GetTime() - startTime) * 1000.0);
+}
+
+// OIT grass needs no sort, so the cost it saves is measured by sorting the visible grass into scratch
+// every PROPS_GRASS_SORT_ESTIMATE_FRAMES frames
+static void EstimateGrassSort(Props* props, Vector3 cameraPosition) {
+    GrassSortState* sort = &props->grassSort;
+    if (sort->estimateCountdown-- > 0) return;
+    sort->estimateCountdown = PROPS_GRASS_SORT_ESTIMATE_FRAMES - 1;
+    int count = GatherVisibleGrass(props);
+    sort->fullSortMs = SortGrassKeys(sort, &props->drawList, cameraPosition, count);
+    sort->valid = false; // The scratch order doesn't match lastPropIndices
 }
 
 // World-oriented quad + wind lean (Rx then Rz, pivot at base). Two opposite windings so both sides draw with backface cull on (rl batch can ignore rlDisableBackfaceCulling).
@@ -283,137 +1323,331 @@ static void DrawGrassTexturedPlane(Vector3 baseCenter, Texture2D tex, Rectangle
     rlSetTexture(0);
 }
 
-static void DrawGroundContactAO(const Prop* prop) {
-    float aoRadius = (prop->type == PROP_MODEL) ? 0.48f : 0.20f;
+static void DrawGroundContactAO(Vector3 position, PropType type) {
+    const PropTypeInfo* info = &PROP_TYPE_INFO[type];
     float aoHeight = 0.01f;
-    float aoYOffset = (prop->type == PROP_MODEL) ? 0.02f : 0.01f;
-    unsigned char aoAlpha = (prop->type == PROP_MODEL) ? 195 : 81;
     Vector3 aoBase = {
-        prop->position.x,
-        prop->position.y + aoYOffset,
-        prop->position.z
+        position.x,
+        position.y + info->aoYOffset,
+        position.z
     };
     Vector3 aoTop = {
-        prop->position.x,
-        prop->position.y + aoYOffset + aoHeight,
-        prop->position.z
+        position.x,
+        position.y + info->aoYOffset + aoHeight,
+        position.z
     };
-    DrawCylinderEx(aoBase, aoTop, aoRadius * 0.55f, aoRadius, 12, (Color){0, 0, 0, aoAlpha});
+    DrawCylinderEx(aoBase, aoTop, info->aoRadius * 0.55f, info->aoRadius, 12, (Color){0, 0, 0, info->aoAlpha});
 }
 
-void DrawProps(Props* props, Camera3D camera) {
-    props->renderedCount = 0;
+// Every prop in the draw list gets a decal in a single instanced draw. Black decals blend as
+// dst * (1 - a), which is order independent, so no sorting or cap is needed.
+static void DrawGroundAoInstances(Props* props) {
+    Shader shader = props->groundAoShader;
+    const PropDrawList* list = &props->drawList;
+    rlDrawRenderBatchActive(); // Flush batched immediate-mode geometry before raw draws
+    for (int k = 0; k < list->count; k++) props->groundAoInstanceIndices[k] = (float)list->indices[k];
+    rlUpdateVertexBuffer(props->groundAoInstanceVbo, props->groundAoInstanceIndices, list->count * (int)sizeof(float), 0);
 
-    const int maxGroundAoDraws = 3500;
-    int groundAoDraws = 0;
+    rlEnableShader(shader.id);
+    Matrix viewProjection = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], viewProjection);
+    int width = props->instanceDataTexture.width;
+    rlSetUniform(props->groundAoInstanceWidthLoc, &width, RL_SHADER_UNIFORM_INT, 1);
+    int dataSlot = 0;
+    rlActiveTextureSlot(dataSlot);
+    rlEnableTexture(props->instanceDataTexture.id);
+    rlSetUniform(props->groundAoInstanceDataLoc, &dataSlot, RL_SHADER_UNIFORM_INT, 1);
+
+    rlDisableBackfaceCulling();
     rlDisableDepthMask();
-    for (int i = 0; i < props->count && groundAoDraws < maxGroundAoDraws; i++) {
-        if (!props->props[i].visible) continue;
-        if (!IsPointInFrustum(props->props[i].position, camera, 1.0f)) continue;
-        DrawGroundContactAO(&props->props[i]);
-        groundAoDraws++;
+    if (rlEnableVertexArray(props->groundAoVao)) {
+        rlDrawVertexArrayInstanced(0, 6, list->count);
+        rlDisableVertexArray();
     }
     rlEnableDepthMask();
+    rlEnableBackfaceCulling();
+
+    rlDisableTexture();
+    rlDisableShader();
+}
+
+// Distance band (start, end) where rock meshes dither out and impostors dither in
+static Vector2 GetImpostorFadeBand(const Props* props) {
+    if (props->impostorInstanceVbo == 0) return (Vector2){ 1e9f, 1e9f + 1.0f }; // Meshes everywhere
+    return (Vector2){ PROPS_IMPOSTOR_DISTANCE - PROPS_IMPOSTOR_FADE_BAND * 0.5f,
+                      PROPS_IMPOSTOR_DISTANCE + PROPS_IMPOSTOR_FADE_BAND * 0.5f };
+}
+
+// One instanced draw per rock mesh; transforms come from instanceDataTexture, indices from rockInstanceVbo
+static void DrawRockInstances(Props* props, int instanceCount) {
+    Shader shader = props->rockInstancedShader;
+    Model model = props->model;
+    rlDrawRenderBatchActive(); // Flush batched immediate-mode geometry (AO) before raw draws
+    rlUpdateVertexBuffer(props->rockInstanceVbo, props->rockInstanceIndices, instanceCount * (int)sizeof(float), 0);
+
+    rlEnableShader(shader.id);
+    Matrix viewProjection = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], viewProjection);
+    rlSetUniformMatrix(props->rockMeshTransformLoc, model.transform);
+    Vector2 fade = GetImpostorFadeBand(props);
+    rlSetUniform(props->rockImpostorFadeLoc, &fade, RL_SHADER_UNIFORM_VEC2, 1);
+    int width = props->instanceDataTexture.width;
+    rlSetUniform(props->rockInstanceWidthLoc, &width, RL_SHADER_UNIFORM_INT, 1);
+    int dataSlot = 2;
+    rlActiveTextureSlot(dataSlot);
+    rlEnableTexture(props->instanceDataTexture.id);
+    rlSetUniform(props->rockInstanceDataLoc, &dataSlot, RL_SHADER_UNIFORM_INT, 1);
+
+    for (int m = 0; m < model.meshCount; m++) {
+        Mesh mesh = model.meshes[m];
+        Material material = model.materials[model.meshMaterial[m]];
+        int albedoSlot = 0;
+        int normalSlot = 1;
+        rlActiveTextureSlot(albedoSlot);
+        rlEnableTexture(material.maps[MATERIAL_MAP_DIFFUSE].texture.id);
+        rlSetUniform(shader.locs[SHADER_LOC_MAP_ALBEDO], &albedoSlot, RL_SHADER_UNIFORM_INT, 1);
+        rlActiveTextureSlot(normalSlot);
+        rlEnableTexture(material.maps[MATERIAL_MAP_NORMAL].texture.id);
+        rlSetUniform(shader.locs[SHADER_LOC_MAP_NORMAL], &normalSlot, RL_SHADER_UNIFORM_INT, 1);
+
+        if (!rlEnableVertexArray(mesh.vaoId)) continue;
+        if (mesh.indices != NULL) rlDrawVertexArrayElementsInstanced(0, mesh.triangleCount * 3, 0, instanceCount);
+        else rlDrawVertexArrayInstanced(0, mesh.vertexCount, instanceCount);
+        rlDisableVertexArray();
+    }
+
+    for (int slot = 2; slot >= 0; slot--) {
+        rlActiveTextureSlot(slot);
+        rlDisableTexture();
+    }
+    rlDisableShader();
+}
+
+// All visible grass in one instanced draw from props->grassInstanceIndices (uploaded when upload is set).
+// Instances rasterize in order, so a far-to-near stream blends like the sorted immediate-mode path.
+static void DrawGrassInstances(Props* props, const GrassShader* grass, int count, bool upload) {
+    Shader shader = grass->shader;
+    rlDrawRenderBatchActive(); // Flush batched immediate-mode geometry before raw draws
+    if (upload) {
+        rlUpdateVertexBuffer(props->grassInstanceVbo, props->grassInstanceIndices, count * (int)sizeof(float), 0);
+    }
+
+    rlEnableShader(shader.id);
+    Matrix viewProjection = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], viewProjection);
+    float t = (float)GetTime();
+    rlSetUniform(grass->timeLoc, &t, RL_SHADER_UNIFORM_FLOAT, 1);
+    int width = props->instanceDataTexture.width;
+    rlSetUniform(grass->instanceWidthLoc, &width, RL_SHADER_UNIFORM_INT, 1);
+    int albedoSlot = 0;
+    int dataSlot = 1;
+    rlActiveTextureSlot(albedoSlot);
+    rlEnableTexture(props->billboardTexture.id);
+    rlSetUniform(shader.locs[SHADER_LOC_MAP_ALBEDO], &albedoSlot, RL_SHADER_UNIFORM_INT, 1);
+    rlActiveTextureSlot(dataSlot);
+    rlEnableTexture(props->instanceDataTexture.id);
+    rlSetUniform(grass->instanceDataLoc, &dataSlot, RL_SHADER_UNIFORM_INT, 1);
+
+    rlDisableBackfaceCulling(); // Blades are single quads seen from both sides
+    rlDisableDepthMask();
+    if (rlEnableVertexArray(props->grassVao)) {
+        rlDrawVertexArrayInstanced(0, 6, count);
+        rlDisableVertexArray();
+    }
+    rlEnableDepthMask();
+    rlEnableBackfaceCulling();
+
+    rlActiveTextureSlot(dataSlot);
+    rlDisableTexture();
+    rlActiveTextureSlot(albedoSlot);
+    rlDisableTexture();
+    rlDisableShader();
+}
+
+// Distant rocks as octahedral impostor cards in one instanced draw (alpha tested, depth writing)
+static void DrawImpostorInstances(Props* props, int instanceCount) {
+    Shader shader = props->impostorShader;
+    rlDrawRenderBatchActive(); // Flush batched immediate-mode geometry before raw draws
+    rlUpdateVertexBuffer(props->impostorInstanceVbo, props->impostorInstanceIndices, instanceCount * (int)sizeof(float), 0);
+
+    rlEnableShader(shader.id);
+    Matrix viewProjection = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], viewProjection);
+    int width = props->instanceDataTexture.width;
+    int frames = PROPS_IMPOSTOR_FRAMES;
+    Vector2 fade = GetImpostorFadeBand(props);
+    Vector4 bounds = { props->impostorCenter.x, props->impostorCenter.y, props->impostorCenter.z, props->impostorRadius };
+    rlSetUniform(props->impostorLocs[1], &width, RL_SHADER_UNIFORM_INT, 1);
+    rlSetUniform(props->impostorLocs[2], &fade, RL_SHADER_UNIFORM_VEC2, 1);
+    rlSetUniform(props->impostorLocs[3], &bounds, RL_SHADER_UNIFORM_VEC4, 1);
+    rlSetUniform(props->impostorLocs[4], &frames, RL_SHADER_UNIFORM_INT, 1);
+    int albedoSlot = 0;
+    int normalSlot = 1;
+    int dataSlot = 2;
+    rlActiveTextureSlot(albedoSlot);
+    rlEnableTexture(props->impostorAlbedo.texture.id);
+    rlSetUniform(shader.locs[SHADER_LOC_MAP_ALBEDO], &albedoSlot, RL_SHADER_UNIFORM_INT, 1);
+    rlActiveTextureSlot(normalSlot);
+    rlEnableTexture(props->impostorNormal.texture.id);
+    rlSetUniform(shader.locs[SHADER_LOC_MAP_NORMAL], &normalSlot, RL_SHADER_UNIFORM_INT, 1);
+    rlActiveTextureSlot(dataSlot);
+    rlEnableTexture(props->instanceDataTexture.id);
+    rlSetUniform(props->impostorLocs[0], &dataSlot, RL_SHADER_UNIFORM_INT, 1);
+
+    rlDisableBackfaceCulling();
+    if (rlEnableVertexArray(props->impostorVao)) {
+        rlDrawVertexArrayInstanced(0, 6, instanceCount);
+        rlDisableVertexArray();
+    }
+    rlEnableBackfaceCulling();
+
+    for (int slot = dataSlot; slot >= 0; slot--) {
+        rlActiveTextureSlot(slot);
+        rlDisableTexture();
+    }
+    rlDisableShader();
+}
+
+bool IsGrassOitAvailable(const Props* props) {
+    return props->grassOitShader.shader.id > 0 && props->grassInstanceVbo != 0;
+}
+
+void DrawProps(Props* props, Camera3D camera) {
+    props->renderedCount = 0;
+
+    if (props->grid.cellStart == NULL) return;
+    BuildPropDrawList(props, camera);
+    const PropDrawList* list = &props->drawList;
+
+    if (list->count > 0 && props->groundAoInstanceVbo != 0) {
+        DrawGroundAoInstances(props);
+    } else {
+        // Immediate-mode fallback keeps the draw cap: each cylinder is a full batch of geometry
+        const int maxGroundAoDraws = 3500;
+        rlDisableDepthMask();
+        for (int k = 0; k < list->count && k < maxGroundAoDraws; k++) {
+            DrawGroundContactAO(list->positions[k], (PropType)props->types[list->indices[k]]);
+        }
+        rlEnableDepthMask();
+    }
     
-    // Arrays to store visible billboards and models for separate processing
-    BillboardDepthInfo* visibleBillboards = (BillboardDepthInfo*)malloc(props->count * sizeof(BillboardDepthInfo));
-    int billboardCount = 0;
-    
-    // First pass: Collect all visible props and calculate distances
-    for (int i = 0; i < props->count; i++) {
-        // Skip props that aren't visible due to LOS
-        if (!props->props[i].visible) continue;
-        
-        // Frustum culling - skip props outside the camera frustum
-        // Use a small margin (1.0f) to avoid popping at frustum edges
-        if (!IsPointInFrustum(props->props[i].position, camera, 1.0f)) continue;
-        
-        // Increment rendered count
-        props->renderedCount++;
-        
-        // For billboards, store for depth sorting
-        if (props->props[i].type == PROP_BILLBOARD) {
-            visibleBillboards[billboardCount].index = i;
-            visibleBillboards[billboardCount].distance = Vector3Distance(camera.position, props->props[i].position);
-            billboardCount++;
-        } else if (props->props[i].type == PROP_MODEL) {
-            // Draw models immediately (they have their own depth testing)
-            float modelScaleRand = HashToUnitFloat((unsigned int)(i * 7919 + 101));
-            float scale = 0.38f + modelScaleRand * 0.34f;
-            float rotationAngle = (float)((i * 37) % 360); // Different rotation for each rock
-            
-            // Draw the model with position, rotation and scale
-            DrawModelEx(props->model, 
-                       props->props[i].position,       // Position
-                       (Vector3){0.0f, 1.0f, 0.0f},  // Rotation axis (Y-up)
-                       rotationAngle,                // Rotation angle
-                       (Vector3){scale, scale, scale}, // Scale
-                       WHITE);                       // Tint
+    // First pass: rocks from the shared draw list (grass is sorted separately below). Inside the
+    // crossfade band a rock goes to both the mesh and the impostor stream; the shaders dither between them.
+    props->renderedCount = list->count;
+    bool instanced = props->rockInstanceVbo != 0;
+    bool impostors = props->impostorInstanceVbo != 0;
+    Vector2 fade = GetImpostorFadeBand(props);
+    float fadeStartSq = fade.x * fade.x;
+    float fadeEndSq = fade.y * fade.y;
+    int rockInstances = 0;
+    int impostorInstances = 0;
+    for (int k = 0; k < list->count; k++) {
+        int i = list->indices[k];
+        if (props->types[i] != PROP_MODEL) continue;
+        if (instanced) {
+            float distSq = Vector3DistanceSqr(list->positions[k], camera.position);
+            if (!impostors || distSq < fadeEndSq) props->rockInstanceIndices[rockInstances++] = (float)i;
+            if (impostors && distSq > fadeStartSq) props->impostorInstanceIndices[impostorInstances++] = (float)i;
+            continue;
         }
+        float scale = 1.0f;
+        float rotationAngle = 0.0f;
+        GetRockTransform(i, &scale, &rotationAngle);
+        DrawModelEx(props->model, list->positions[k], (Vector3){0.0f, 1.0f, 0.0f}, rotationAngle,
+                    (Vector3){scale, scale, scale}, WHITE);
     }
+    if (rockInstances > 0) DrawRockInstances(props, rockInstances);
+    if (impostorInstances > 0) DrawImpostorInstances(props, impostorInstances);
     
+    // Weighted blended OIT draws grass later into its own target (DrawPropsGrassOit)
+    if (props->grassOitEnabled && IsGrassOitAvailable(props)) {
+        EstimateGrassSort(props, camera.position);
+        return;
+    }
+
     // Sort grass planes by distance (far to near)
-    if (billboardCount > 0) {
-        qsort(visibleBillboards, billboardCount, sizeof(BillboardDepthInfo), CompareBillboardDepth);
-        
+    SortVisibleGrass(props, camera.position);
+    const GrassSortState* sort = &props->grassSort;
+    if (sort->count > 0 && props->grassInstanceVbo != 0) {
+        bool upload = !sort->skipped;
+        if (upload) {
+            for (int n = 0; n < sort->count; n++) {
+                props->grassInstanceIndices[n] = (float)list->indices[sort->slots[sort->order[n]]];
+            }
+        }
+        DrawGrassInstances(props, &props->grassShader, sort->count, upload);
+    } else if (sort->count > 0) {
         // Enable alpha blending for proper transparency
         rlDisableDepthMask();  // Disable depth writes
         
         float t = (float)GetTime();
-        for (int i = 0; i < billboardCount; i++) {
-            int index = visibleBillboards[i].index;
-            Vector3 p = props->props[index].position;
-            float yaw = 0.0f;
-            float pitch = 0.0f;
-            GrassFieldAngles(p.x, p.z, &yaw, &pitch);
-            float randA = HashToUnitFloat((unsigned int)(index * 9781 + 17));
-            float randB = HashToUnitFloat((unsigned int)(index * 6271 + 53));
-            float speed = 0.8f + randA * 1.6f;
-            float phase = randB * PI * 2.0f;
-            float maxLeanRad = (5.0f + randA * 11.0f) * DEG2RAD;
-            float leanAx = sinf(t * speed + phase) * maxLeanRad;
-            float leanAz = cosf(t * (speed * 0.73f) + phase * 1.37f) * maxLeanRad * 0.48f;
-            DrawGrassTexturedPlane(p, props->billboardTexture, props->billboardSourceRec, props->billboardSize, yaw, pitch, leanAx, leanAz, WHITE);
+        for (int n = 0; n < sort->count; n++) {
+            int slot = sort->slots[sort->order[n]];
+            Vector3 p = list->positions[slot];
+            GrassBladeParams blade = GetGrassBladeParams(list->indices[slot], p);
+            float leanAx = sinf(t * blade.speed + blade.phase) * blade.maxLean;
+            float leanAz = cosf(t * (blade.speed * 0.73f) + blade.phase * 1.37f) * blade.maxLean * 0.48f;
+            DrawGrassTexturedPlane(p, props->billboardTexture, props->billboardSourceRec, props->billboardSize, blade.yaw, blade.pitch, leanAx, leanAz, WHITE);
         }
         
         // Restore depth mask
         rlEnableDepthMask();
     }
-    
-    // Free allocated memory
-    free(visibleBillboards);
+}
+
+void DrawPropsGrassOit(Props* props) {
+    if (!props->grassOitEnabled || !IsGrassOitAvailable(props)) return;
+    const PropDrawList* list = &props->drawList;
+    int count = 0;
+    for (int k = 0; k < list->count; k++) {
+        int i = list->indices[k];
+        if (props->types[i] == PROP_BILLBOARD) props->grassInstanceIndices[count++] = (float)i;
+    }
+    props->grassSort.valid = false; // The instance stream no longer holds the sorted order
+    if (count == 0) return;
+
+    // Both OIT targets accumulate additively: premultiplied weighted color and -log(1 - alpha)
+    rlSetBlendFactors(RL_ONE, RL_ONE, RL_FUNC_ADD);
+    rlSetBlendMode(BLEND_CUSTOM);
+    DrawGrassInstances(props, &props->grassOitShader, count, true);
+    rlSetBlendMode(BLEND_ALPHA);
 }
 
 void DrawPropsDebug(Props* props, Camera3D camera) {
-    for (int i = 0; i < props->count; i++) {
-        // Skip props that aren't active
-        if (props->props[i].position.x == 0.0f && 
-            props->props[i].position.y == 0.0f && 
-            props->props[i].position.z == 0.0f) {
-            continue;
-        }
-        
-        // Draw ray from camera to prop
-        Vector3 direction = Vector3Subtract(props->props[i].position, camera.position);
-        float distance = Vector3Length(direction);
-        
-        // Skip props that are too far away
-        float maxDistance = (props->props[i].type == PROP_MODEL) ? LOS_MAX_ROCK_DISTANCE : LOS_MAX_GRASS_DISTANCE;
-        if (distance > maxDistance) {
-            continue;
-        }
-        
-        // Draw ray in green if visible, red if not
-        Color rayColor = props->props[i].visible ? GREEN : RED;
-        DrawLine3D(camera.position, props->props[i].position, rayColor);
-        
-        // Draw sphere at prop position - blue for billboards, yellow for models
-        Color sphereColor = props->props[i].type == PROP_BILLBOARD ? BLUE : YELLOW;
-        DrawSphere(props->props[i].position, 0.1f, sphereColor);
+    const PropGrid* grid = &props->grid;
+    float maxRange = fmaxf(LOS_MAX_ROCK_DISTANCE, LOS_MAX_GRASS_DISTANCE);
+    PropGridRect rect = GetPropGridRect(grid, camera.position, maxRange);
+    for (int cz = rect.minZ; cz <= rect.maxZ; cz++) {
+        for (int cx = rect.minX; cx <= rect.maxX; cx++) {
+            int c = GetPropGridCell(cx, cz);
+            PropCellDecode decode = GetPropCellDecode(grid, c);
+            for (int i = grid->cellStart[c]; i < grid->cellEnd[c]; i++) {
+                Vector3 position = DecodePropPosition(props, decode, i);
+                PropType type = (PropType)props->types[i];
 
-        // Draw proxy bounds used for LOS decisions
-        Color bboxColor = props->props[i].isOccluder ? ORANGE : SKYBLUE;
-        DrawBoundingBox(props->props[i].dummyBounds, bboxColor);
+                // Draw ray from camera to prop
+                Vector3 direction = Vector3Subtract(position, camera.position);
+                float distance = Vector3Length(direction);
+                
+                // Skip props that are too far away
+                float maxDistance = (type == PROP_MODEL) ? LOS_MAX_ROCK_DISTANCE : LOS_MAX_GRASS_DISTANCE;
+                if (distance > maxDistance) {
+                    continue;
+                }
+                
+                // Draw ray in green if visible, red if not
+                Color rayColor = IsPropVisible(props, i) ? GREEN : RED;
+                DrawLine3D(camera.position, position, rayColor);
+                
+                // Draw sphere at prop position - blue for billboards, yellow for models
+                Color sphereColor = type == PROP_BILLBOARD ? BLUE : YELLOW;
+                DrawSphere(position, 0.1f, sphereColor);
+
+                // Draw proxy bounds used for LOS decisions
+                Color bboxColor = PROP_TYPE_INFO[type].isOccluder ? ORANGE : SKYBLUE;
+                DrawBoundingBox(GetPropBounds(position, type), bboxColor);
+            }
+        }
     }
 }
 
@@ -423,7 +1657,70 @@ void UnloadProps(Props* props) {
     
     // Unload model
     UnloadModel(props->model);
+    UnloadTexture(props->instanceDataTexture);
+    if (props->rockInstanceVbo != 0) rlUnloadVertexBuffer(props->rockInstanceVbo);
+    if (props->grassInstanceVbo != 0) rlUnloadVertexBuffer(props->grassInstanceVbo);
+    if (props->grassVao != 0) {
+        rlUnloadVertexArray(props->grassVao);
+        rlUnloadVertexBuffer(props->grassQuadVbo[0]);
+        rlUnloadVertexBuffer(props->grassQuadVbo[1]);
+    }
+    if (props->grassShader.shader.id > 0) UnloadShader(props->grassShader.shader);
+    if (props->grassOitShader.shader.id > 0) UnloadShader(props->grassOitShader.shader);
+    if (props->groundAoInstanceVbo != 0) rlUnloadVertexBuffer(props->groundAoInstanceVbo);
+    if (props->groundAoVao != 0) {
+        rlUnloadVertexArray(props->groundAoVao);
+        rlUnloadVertexBuffer(props->groundAoQuadVbo);
+    }
+    if (props->groundAoShader.id > 0) UnloadShader(props->groundAoShader);
+    if (props->impostorInstanceVbo != 0) rlUnloadVertexBuffer(props->impostorInstanceVbo);
+    if (props->impostorVao != 0) {
+        rlUnloadVertexArray(props->impostorVao);
+        rlUnloadVertexBuffer(props->impostorQuadVbo);
+    }
+    if (props->impostorShader.id > 0) {
+        UnloadShader(props->impostorShader);
+        UnloadRenderTexture(props->impostorAlbedo);
+        UnloadRenderTexture(props->impostorNormal);
+    }
     
     // Free memory
-    free(props->props);
+    free(props->posX);
+    free(props->posY);
+    free(props->posZ);
+    free(props->types);
+    free(props->visibleBits);
+    free(props->tileCounts);
+    free(props->rockInstanceIndices);
+    free(props->grassInstanceIndices);
+    free(props->groundAoInstanceIndices);
+    free(props->impostorInstanceIndices);
+    free(props->drawList.indices);
+    free(props->drawList.positions);
+    free(props->grassSort.keys);
+    free(props->grassSort.keysTemp);
+    free(props->grassSort.slots);
+    free(props->grassSort.orderA);
+    free(props->grassSort.orderB);
+    free(props->grassSort.propIndices);
+    free(props->grassSort.lastPropIndices);
+    free(props->cullX);
+    free(props->cullY);
+    free(props->cullZ);
+    free(props->cullSource);
+    free(props->cullLocal);
+    free(props->grid.cellStart);
+    free(props->grid.cellEnd);
+    free(props->grid.cellBaseX);
+    free(props->grid.cellBaseZ);
+    free(props->grid.cellMinY);
+    free(props->grid.cellMaxY);
+    free(props->grid.viewCells);
+    free(props->grid.viewCellPassed);
+    free(props->grid.cellVisibleCount);
+    free(props->grid.cellLosTime);
+    free(props->grid.cellLosWaitStart);
+    free(props->grid.cellLosCamera);
+    free(props->grid.losCells);
+    free(props->grid.losCandidates);
 }
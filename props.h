@@ -3,56 +3,211 @@
 
 #include "common.h"
 #include "scene.h"
+#include "culling.h"
+#include "jobs.h"
 
 // Prop types
 typedef enum {
     PROP_BILLBOARD,  // 2D billboard (grass, etc.)
-    PROP_MODEL       // 3D model (rocks, etc.)
+    PROP_MODEL,      // 3D model (rocks, etc.)
+    PROP_TYPE_COUNT
 } PropType;
 
-// Individual prop data
+// Per-type constants; bounds are derived from position + this table instead of stored per prop
 typedef struct {
-    Vector3 position;
-    bool visible;
-    PropType type;   // Type of prop (billboard or 3D model)
-    BoundingBox dummyBounds; // CPU-side proxy volume for LOS testing
     Vector3 dummyHalfExtents; // Half extents for dummy LOS cube
-    bool isOccluder; // Whether this prop can occlude others in LOS
-} Prop;
+    bool isOccluder;          // Whether props of this type can occlude others in LOS
+    float aoRadius;           // Ground-contact AO decal radius
+    float aoYOffset;          // Decal height above the prop base
+    unsigned char aoAlpha;    // Decal darkness at the center
+} PropTypeInfo;
 
-// Props collection
+extern const PropTypeInfo PROP_TYPE_INFO[PROP_TYPE_COUNT];
+
+// Candidate cell for the time-sliced LOS queue
+typedef struct {
+    int cell;
+    float priority;
+} PropLosCandidate;
+
+// Uniform grid over the resident window. Cells are tile-major: the PROPS_GRID_CELLS_PER_TILE^2 cells of
+// a tile share its slot, and each cell is a contiguous range of that tile's block of the prop pool.
+typedef struct {
+    float cellSize;      // Cell edge length in world meters
+    int cellsX;          // Window edge in cells
+    int cellsZ;
+    int windowX;         // World cell coordinate of the window's min corner
+    int windowZ;
+    int* cellStart;      // Cell c owns props [cellStart[c], cellEnd[c])
+    int* cellEnd;
+    float* cellBaseX;    // World X/Z of each cell's min corner (quantization base)
+    float* cellBaseZ;
+    float* cellMinY;     // Lowest prop position per cell (quantization base and cell culling)
+    float* cellMaxY;     // Highest prop position per cell
+    int* viewCells;      // Scratch list of cells that passed the frustum test this frame
+    int* viewCellPassed; // Props each view cell contributed to the draw list
+    int* cellVisibleCount;   // LOS-visible props per cell from its last evaluation
+    double* cellLosTime;     // GetTime() of each cell's last LOS pass; < 0 = never since entering range
+    double* cellLosWaitStart; // GetTime() a never-evaluated cell was first seen in range; < 0 = not yet
+    Vector3* cellLosCamera;  // Camera position used for each cell's last LOS pass
+    int* losCells;           // Scratch: cells queued for LOS this frame
+    PropLosCandidate* losCandidates; // Scratch: time-sliced priority queue
+} PropGrid;
+
+// Inclusive cell range; empty when maxX < minX
+typedef struct {
+    int minX;
+    int minZ;
+    int maxX;
+    int maxZ;
+} PropGridRect;
+
+// Compact per-frame list of props that passed LOS and frustum culling; shared by every draw pass
+typedef struct {
+    int* indices;        // Prop indices
+    Vector3* positions;  // Decoded positions matching indices
+    int count;
+} PropDrawList;
+
+// Persistent buffers for the per-frame far-to-near grass sort
+typedef struct {
+    unsigned int* keys;          // Radix keys (inverted squared-distance bits)
+    unsigned int* keysTemp;
+    int* slots;                  // Draw-list slot of each visible grass prop this frame
+    int* orderA;                 // Radix ping-pong buffers of indices into slots
+    int* orderB;
+    int* order;                  // Points at orderA or orderB: indices into slots, far to near
+    int* propIndices;            // Prop indices of this frame's visible grass, in draw-list order
+    int* lastPropIndices;        // Same for the frame that was last sorted
+    int count;
+    int lastCount;
+    Vector3 lastCamera;          // Camera position of the last sort
+    bool valid;                  // order holds a usable result
+    bool skipped;                // Last call reused the previous order
+    float sortMs;                // Time spent in the last sort call (near 0 when skipped)
+    float fullSortMs;            // Key build + radix sort time of the last sort that ran (what OIT saves)
+    int estimateCountdown;       // OIT frames until the next scratch sort refreshes fullSortMs
+} GrassSortState;
+
+// Instanced grass program and its per-draw uniforms
+typedef struct {
+    Shader shader;
+    int timeLoc;
+    int instanceDataLoc;
+    int instanceWidthLoc;
+} GrassShader;
+
+// One tile's scatter, generated off the main thread by GeneratePropTile
 typedef struct {
-    Prop* props;
+    int tileX;
+    int tileZ;
     int count;
+    Vector3 positions[PROPS_TILE_CAPACITY];
+    unsigned char types[PROPS_TILE_CAPACITY]; // PropType
+} PropTileData;
+
+// Props collection
+typedef struct {
+    int count;                   // Pool slots: PROPS_TILE_CAPACITY per resident-window tile
+    int residentCount;           // Props in committed tiles
+    int* tileCounts;             // Props per tile slot
+    // Structure-of-arrays pool; tile slot s owns [s * PROPS_TILE_CAPACITY, ...), ordered by grid cell.
+    // Positions are 16-bit fractions of the owning cell: X/Z across cellSize, Y across [cellMinY, cellMaxY].
+    unsigned short* posX;
+    unsigned short* posY;
+    unsigned short* posZ;
+    unsigned char* types;        // PropType per prop
+    unsigned int* visibleBits;   // LOS visibility, one bit per prop
     Texture2D billboardTexture;  // Texture for billboard props
     Rectangle billboardSourceRec; // Source rectangle for billboard texture
     Vector2 billboardSize;       // Size of billboards
     Model model;                 // 3D model for model props
     bool rockHasNormalMap;       // Lighting shader samples texture1 when drawing rocks
+    Shader rockInstancedShader;  // lighting_instanced.vs + lighting.fs (id 0 = per-rock DrawModelEx)
+    int rockMeshTransformLoc;
+    int rockInstanceDataLoc;
+    int rockInstanceWidthLoc;
+    int rockImpostorFadeLoc;
+    Shader impostorShader;       // impostor.vs/fs cards for distant rocks (id 0 = meshes at every distance)
+    int impostorLocs[5];         // instanceData, instanceDataWidth, impostorFade, impostorBounds, impostorFrames
+    RenderTexture2D impostorAlbedo; // PROPS_IMPOSTOR_FRAMES^2 hemi-octahedral views, alpha = coverage
+    RenderTexture2D impostorNormal; // Model-space normals of the same views
+    Vector3 impostorCenter;      // Model-space bounding sphere the views were framed on
+    float impostorRadius;
+    unsigned int impostorVao;    // Card quad plus the per-instance distant rock stream
+    unsigned int impostorQuadVbo;
+    unsigned int impostorInstanceVbo;
+    float* impostorInstanceIndices;
+    GrassShader grassShader;     // grass.vs/fs: wind lean on the GPU (id 0 = immediate-mode quads)
+    GrassShader grassOitShader;  // grass.vs + grass_oit.fs: weighted blended OIT, no sort
+    bool grassOitEnabled;        // Draw grass through DrawPropsGrassOit instead of sorting (F3)
+    Texture2D instanceDataTexture; // RGBA32F per-prop constants; each tile writes its rows in CommitPropTile
+    unsigned int rockInstanceVbo;  // Visible rock prop indices, one float per instance
+    float* rockInstanceIndices;    // CPU side of rockInstanceVbo, refilled each frame
+    Shader groundAoShader;         // ground_ao.vs/fs decals (id 0 = capped DrawCylinderEx fallback)
+    int groundAoInstanceDataLoc;
+    int groundAoInstanceWidthLoc;
+    unsigned int groundAoVao;      // Unit decal quad plus the per-instance draw list stream
+    unsigned int groundAoQuadVbo;
+    unsigned int groundAoInstanceVbo; // Every prop in the draw list, one float index per decal
+    float* groundAoInstanceIndices;
+    unsigned int grassVao;         // Blade quad plus the per-instance grass index stream
+    unsigned int grassQuadVbo[2];  // Blade corners, texcoords
+    unsigned int grassInstanceVbo; // Sorted visible grass prop indices, far to near
+    float* grassInstanceIndices;   // CPU side of grassInstanceVbo
     Vector3 lastCameraPosition;  // Last camera position when LOS was checked
     bool needsLOSUpdate;         // Flag to force LOS update
+    bool losTimeSliced;          // Re-check the most urgent cells each frame within losBudgetMicros
+    int losBudgetMicros;         // Per-frame LOS budget in time-sliced mode
+    float losOldestPendingMs;    // Age of the oldest cell result still awaiting a re-check
     int visibleCount;            // Number of props visible after LOS check
     int renderedCount;           // Number of props actually rendered (after frustum culling)
+    const HiZBuffer* occlusion;  // Read-back scene depth for occlusion culling (NULL = none)
+    bool occlusionCulling;       // Test view cells and rocks against occlusion (F4)
+    int occludedCount;           // Props rejected by the Hi-Z test this frame
+    PropGrid grid;               // Spatial index, filled tile by tile
+    PropGridRect losRect;        // Cells evaluated by the last LOS update
+    JobSystem* jobs;             // Worker pool for LOS and culling (NULL = main thread only)
+    PropDrawList drawList;       // Rebuilt at the start of DrawProps
+    GrassSortState grassSort;    // Far-to-near order of the draw list's grass
+    int cullScratchStride;       // Scratch slots per job thread (largest possible cell)
+    float* cullX;                // Per-thread SoA scratch for one cell's decoded positions (batched frustum test)
+    float* cullY;
+    float* cullZ;
+    int* cullSource;             // Prop index for each scratch slot
+    int* cullLocal;              // Scratch slots that passed the frustum test
 } Props;
 
-// Initialize props with billboard and model data
-Props InitProps(int billboardCount, int modelCount, const char* billboardTexturePath, const char* modelPath, const char* modelTexturePath, const char* modelNormalMapPath, Shader lightingShader);
+// Initialize props with billboard and model data and an empty tile pool; rocks draw instanced through
+// rockInstancedShader when it loaded. jobs (may be NULL) parallelizes LOS and culling
+Props InitProps(const char* billboardTexturePath, const char* modelPath, const char* modelTexturePath, const char* modelNormalMapPath, Shader lightingShader, Shader rockInstancedShader, JobSystem* jobs);
 
-// Add a billboard prop at the specified position
-void AddBillboardProp(Props* props, Vector3 position, int index);
+// Scatter grassCount grass and rockCount rocks over a generated terrain tile with blue-noise spacing,
+// denser where the slope suits the type. Chunks of the tile fill in parallel on jobs (may be NULL); the
+// result depends only on the tile and seed, never on the thread count. Touches no shared state.
+void GeneratePropTile(const TerrainTileData* terrain, int grassCount, int rockCount, unsigned int seed, JobSystem* jobs, PropTileData* out);
 
-// Add a model prop at the specified position
-void AddModelProp(Props* props, Vector3 position, int index);
+// Main thread: index, quantize and upload a generated tile into its slot of the pool
+void CommitPropTile(Props* props, const PropTileData* tile);
 
-// Update prop visibility based on line of sight
-void UpdatePropVisibility(Props* props, Scene scene, Camera3D camera);
+// Main thread: empty a tile slot
+void EvictPropTile(Props* props, int slot);
+
+// Move the grid window; its min corner is in world tiles. Cells outside it are never visited.
+void SetPropGridWindow(Props* props, int tileX, int tileZ);
 
-// Check if a point is within the camera frustum (with margin)
-bool IsPointInFrustum(Vector3 point, Camera3D camera, float margin);
+// Update prop visibility based on line of sight
+void UpdatePropVisibility(Props* props, const Scene* scene, Camera3D camera);
 
-// Draw visible props
+// Draw visible props (grass is left to DrawPropsGrassOit while grassOitEnabled)
 void DrawProps(Props* props, Camera3D camera);
 
+// Weighted blended OIT needs the instanced grass path and the OIT shader
+bool IsGrassOitAvailable(const Props* props);
+
+// Draw this frame's visible grass, unsorted, into the bound OIT accumulation targets (after DrawProps)
+void DrawPropsGrassOit(Props* props);
+
 // Draw debug visualization for props
 void DrawPropsDebug(Props* props, Camera3D camera);
 
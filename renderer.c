@@ -1,5 +1,18 @@
+#define GL_GLEXT_PROTOTYPES
 #include "renderer.h"
 #include "rlgl.h"
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DOF_TILE_TEXTURE_UNIT 5 // First unit past rlgl's batch (texture0 + RL_DEFAULT_BATCH_MAX_TEXTURE_UNITS)
+
+// Frame graph names of the DOF chain levels
+static const char* DOF_CHAIN_NAMES[] = { "dofHalf", "dofQuarter", "dofEighth", "dofSixteenth" };
+#if DOF_BLUR_LEVELS > 4
+#error "Name the extra DOF chain levels in DOF_CHAIN_NAMES"
+#endif
 
 // Color + depth texture FBO (raylib LoadRenderTexture uses a depth renderbuffer — not sampleable for DOF)
 static RenderTexture2D LoadRenderTextureDepthReadable(int width, int height) {
@@ -30,6 +43,52 @@ static RenderTexture2D LoadRenderTextureDepthReadable(int width, int height) {
     return target;
 }
 
+// Grass OIT targets: RGBA16F accumulation + R16F log-revealage, depth-tested against the props depth.
+// Both clear to 0 and blend ONE, ONE, so no per-attachment blend state is needed.
+static RenderTexture2D LoadGrassOitTarget(RenderTexture2D propsTarget, Texture2D* revealage) {
+    int width = propsTarget.texture.width;
+    int height = propsTarget.texture.height;
+    RenderTexture2D target = {0};
+    target.id = rlLoadFramebuffer();
+    if (target.id == 0) return target;
+
+    rlEnableFramebuffer(target.id);
+
+    target.texture.id = rlLoadTexture(NULL, width, height, PIXELFORMAT_UNCOMPRESSED_R16G16B16A16, 1);
+    target.texture.width = width;
+    target.texture.height = height;
+    target.texture.format = PIXELFORMAT_UNCOMPRESSED_R16G16B16A16;
+    target.texture.mipmaps = 1;
+
+    revealage->id = rlLoadTexture(NULL, width, height, PIXELFORMAT_UNCOMPRESSED_R16, 1);
+    revealage->width = width;
+    revealage->height = height;
+    revealage->format = PIXELFORMAT_UNCOMPRESSED_R16;
+    revealage->mipmaps = 1;
+
+    target.depth = propsTarget.depth;
+
+    rlFramebufferAttach(target.id, target.texture.id, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+    rlFramebufferAttach(target.id, revealage->id, RL_ATTACHMENT_COLOR_CHANNEL1, RL_ATTACHMENT_TEXTURE2D, 0);
+    rlFramebufferAttach(target.id, target.depth.id, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_TEXTURE2D, 0);
+    rlActiveDrawBuffers(2); // Draw-buffer state is per framebuffer, so this sticks
+
+    if (!rlFramebufferComplete(target.id)) {
+        printf("ERROR: Grass OIT FBO incomplete, grass is always sorted\n");
+        rlDisableFramebuffer();
+        rlUnloadTexture(target.texture.id);
+        rlUnloadTexture(revealage->id);
+        *revealage = (Texture2D){0};
+        // Detach the shared depth first: rlUnloadFramebuffer deletes whatever depth is attached
+        rlFramebufferAttach(target.id, 0, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_TEXTURE2D, 0);
+        rlUnloadFramebuffer(target.id);
+        return (RenderTexture2D){0};
+    }
+
+    rlDisableFramebuffer();
+    return target;
+}
+
 // Matches GetScreenToWorldRayEx: view = LookAt, proj = Perspective/Ortho, inv(view*proj) for depth unproject
 static Matrix DofInvViewProj(Camera3D camera, int fbWidth, int fbHeight) {
     Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
@@ -64,28 +123,74 @@ static const char* SKYBOX_FS = "#version 330\n"
 "finalColor = texture(environmentMap, normalize(texCoord));\n"
 "}\n";
 
+// Props viewport for a scale, clamped to the allocated target
+static void SetPropsScale(Renderer* renderer, float scale) {
+    int maxW = renderer->quarterResTarget.texture.width;
+    int maxH = renderer->quarterResTarget.texture.height;
+    renderer->propsScale = scale;
+    renderer->propsWidth = (int)(renderer->fullResTarget.texture.width * scale);
+    renderer->propsHeight = (int)(renderer->fullResTarget.texture.height * scale);
+    if (renderer->propsWidth < 1) renderer->propsWidth = 1;
+    if (renderer->propsHeight < 1) renderer->propsHeight = 1;
+    if (renderer->propsWidth > maxW) renderer->propsWidth = maxW;
+    if (renderer->propsHeight > maxH) renderer->propsHeight = maxH;
+}
+
+// LoadShader with props_merge.glsl spliced in after the fragment shader's #version line (GLSL has no #include)
+static Shader LoadShaderWithPropsMerge(const char* vsPath, const char* fsPath) {
+    Shader shader = {0};
+    char* vs = (vsPath != NULL) ? LoadFileText(vsPath) : NULL;
+    char* fs = LoadFileText(fsPath);
+    char* merge = LoadFileText("resources/shaders/props_merge.glsl");
+    char* versionEnd = (fs != NULL) ? strchr(fs, '\n') : NULL;
+    if (versionEnd != NULL && merge != NULL && (vsPath == NULL || vs != NULL)) {
+        size_t versionLength = (size_t)(versionEnd - fs) + 1;
+        size_t mergeLength = strlen(merge);
+        size_t restLength = strlen(versionEnd + 1);
+        char* source = malloc(versionLength + mergeLength + 1 + restLength + 1);
+        if (source != NULL) {
+            memcpy(source, fs, versionLength);
+            memcpy(source + versionLength, merge, mergeLength);
+            source[versionLength + mergeLength] = '\n';
+            memcpy(source + versionLength + mergeLength + 1, versionEnd + 1, restLength + 1);
+            shader = LoadShaderFromMemory(vs, source);
+            free(source);
+        }
+    }
+    if (vs != NULL) UnloadFileText(vs);
+    if (fs != NULL) UnloadFileText(fs);
+    if (merge != NULL) UnloadFileText(merge);
+    return shader;
+}
+
+static bool IsDofAvailable(const Renderer* renderer) {
+    return renderer->dofDownsampleShader.id != 0 && renderer->dofBlurShader.id != 0 && renderer->dofCompositeShader.id != 0 &&
+           renderer->dofTileShader.id != 0;
+}
+
 Renderer InitRenderer(int width, int height, float propsScale) {
     Renderer renderer = {0};
     
-    // Full / quarter FBOs need sampleable depth for distance-based DOF
-    int qw = (int)(width * propsScale);
-    int qh = (int)(height * propsScale);
+    // Full / quarter FBOs need sampleable depth for distance-based DOF. The props target is sized for
+    // the largest scale dynamic resolution may pick, so changing the scale never reallocates it.
+    float maxScale = (propsScale > PROPS_RENDER_SCALE_MAX) ? propsScale : PROPS_RENDER_SCALE_MAX;
+    int qw = (int)(width * maxScale);
+    int qh = (int)(height * maxScale);
     if (qw < 1) qw = 1;
     if (qh < 1) qh = 1;
     renderer.fullResTarget = LoadRenderTextureDepthReadable(width, height);
     renderer.quarterResTarget = LoadRenderTextureDepthReadable(qw, qh);
-    renderer.compositeTarget = LoadRenderTexture(width, height);
-    renderer.blurPing = LoadRenderTexture(width, height);
-    renderer.blurPong = LoadRenderTexture(width, height);
+    renderer.propsScaleDefault = propsScale;
+    SetPropsScale(&renderer, propsScale);
+    glGenQueries(PROPS_TIMER_QUERIES, renderer.propsTimerQueries);
+    // Composite, DOF chain, blur and tile targets are transient: the frame graph pools them
+    renderer.frameGraph = InitFrameGraph();
     
     // Apply texture filtering to both render targets with their respective modes
     SetTextureFilter(renderer.fullResTarget.texture, MAIN_TEXTURE_FILTER_MODE);
     SetTextureFilter(renderer.quarterResTarget.texture, PROPS_TEXTURE_FILTER_MODE);
     SetTextureFilter(renderer.fullResTarget.depth, TEXTURE_FILTER_POINT);
     SetTextureFilter(renderer.quarterResTarget.depth, TEXTURE_FILTER_POINT);
-    SetTextureFilter(renderer.compositeTarget.texture, MAIN_TEXTURE_FILTER_MODE);
-    SetTextureFilter(renderer.blurPing.texture, MAIN_TEXTURE_FILTER_MODE);
-    SetTextureFilter(renderer.blurPong.texture, MAIN_TEXTURE_FILTER_MODE);
     
     // Load and initialize the lighting shader
     renderer.lightingShader = LoadShader(
@@ -102,10 +207,63 @@ Renderer InitRenderer(int width, int height, float propsScale) {
         renderer.lightingShader.locs[SHADER_LOC_MAP_NORMAL] = GetShaderLocation(renderer.lightingShader, "texture1");
     }
 
+    renderer.lightingInstancedShader = LoadShader(
+        "resources/shaders/lighting_instanced.vs",
+        "resources/shaders/lighting.fs"
+    );
+    if (renderer.lightingInstancedShader.id == 0) {
+        printf("ERROR: Failed to load instanced lighting shader, rocks use per-rock draws\n");
+    } else {
+        renderer.lightingInstancedShader.locs[SHADER_LOC_MAP_ALBEDO] = GetShaderLocation(renderer.lightingInstancedShader, "texture0");
+        renderer.lightingInstancedShader.locs[SHADER_LOC_MAP_NORMAL] = GetShaderLocation(renderer.lightingInstancedShader, "texture1");
+    }
+
+    renderer.terrainShader = LoadShader(
+        "resources/shaders/terrain.vs",
+        "resources/shaders/lighting.fs"
+    );
+    if (renderer.terrainShader.id == 0) {
+        printf("ERROR: Failed to load terrain shader, terrain falls back to a single coarse mesh\n");
+    } else {
+        renderer.terrainShader.locs[SHADER_LOC_MAP_ALBEDO] = GetShaderLocation(renderer.terrainShader, "texture0");
+        renderer.terrainShader.locs[SHADER_LOC_MAP_NORMAL] = GetShaderLocation(renderer.terrainShader, "texture1");
+    }
+
+    renderer.grassOitResolveShader = LoadShader(NULL, "resources/shaders/grass_oit_resolve.fs");
+    if (renderer.grassOitResolveShader.id == 0) {
+        printf("ERROR: Failed to load grass OIT resolve shader, grass is always sorted\n");
+    } else {
+        renderer.grassOitTarget = LoadGrassOitTarget(renderer.quarterResTarget, &renderer.grassOitRevealage);
+    }
+
+    if (renderer.fullResTarget.depth.id != 0) renderer.hiz = InitHiZPyramid(width, height, HIZ_LEVELS);
+
+    renderer.propsUpsampleShader = LoadShaderWithPropsMerge(NULL, "resources/shaders/props_upsample.fs");
+    if (renderer.propsUpsampleShader.id == 0) printf("ERROR: Failed to load props upsample shader, props are stretched bilinearly\n");
+
+    renderer.dofDownsampleShader = LoadShaderWithPropsMerge(NULL, "resources/shaders/dof_downsample.fs");
     renderer.dofBlurShader = LoadShader("resources/shaders/dof_blur.vs", "resources/shaders/dof_blur.fs");
-    renderer.dofCompositeShader = LoadShader("resources/shaders/dof_composite.vs", "resources/shaders/dof_composite.fs");
+    renderer.dofCompositeShader = LoadShaderWithPropsMerge("resources/shaders/dof_composite.vs", "resources/shaders/dof_composite.fs");
+    if (renderer.dofDownsampleShader.id == 0) printf("ERROR: Failed to load DOF downsample shader\n");
     if (renderer.dofBlurShader.id == 0) printf("ERROR: Failed to load DOF blur shader\n");
     if (renderer.dofCompositeShader.id == 0) printf("ERROR: Failed to load DOF composite shader\n");
+    renderer.dofTileShader = LoadShaderWithPropsMerge(NULL, "resources/shaders/dof_tiles.fs");
+    if (renderer.dofTileShader.id == 0) {
+        printf("ERROR: Failed to load DOF tile shader\n");
+    } else {
+        int tilesX = (width + DOF_TILE_SIZE - 1) / DOF_TILE_SIZE;
+        int tilesY = (height + DOF_TILE_SIZE - 1) / DOF_TILE_SIZE;
+        glGenBuffers(DOF_TILE_READBACK_SLOTS, renderer.dofTilePbo);
+        for (int slot = 0; slot < DOF_TILE_READBACK_SLOTS; slot++) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, renderer.dofTilePbo[slot]);
+            glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)tilesX * tilesY, NULL, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    // The fused path merges props inside the DOF passes, so the composite target only exists while it is off
+    renderer.dofEnabled = true;
+    SetFusedComposite(&renderer, true);
     
     // Set default light position
     renderer.lightPosition = (Vector3){0.0f, 6.0f, 0.0f};
@@ -210,107 +368,522 @@ void EndFullResRender(void) {
     EndTextureMode();
 }
 
+void UpdateSceneOcclusion(Renderer* renderer, Camera3D camera) {
+    float aspect = (float)renderer->fullResTarget.texture.width / (float)renderer->fullResTarget.texture.height;
+    UpdateHiZPyramid(&renderer->hiz, renderer->fullResTarget.depth, GetCameraViewProjection(camera, aspect));
+}
+
 void BeginQuarterResRender(Renderer renderer) {
     BeginTextureMode(renderer.quarterResTarget);
+    // Only the props corner is drawn, cleared and later sampled; the rest of the target is never read
+    rlViewport(0, 0, renderer.propsWidth, renderer.propsHeight);
+    rlEnableScissorTest();
+    rlScissor(0, 0, renderer.propsWidth, renderer.propsHeight);
     ClearBackground(BLANK); // Clear with transparency
+    rlDisableScissorTest();
+    if (renderer.propsTimerQueries[0] != 0) {
+        glBeginQuery(GL_TIME_ELAPSED, renderer.propsTimerQueries[renderer.propsTimerFrame % PROPS_TIMER_QUERIES]);
+    }
 }
 
 void EndQuarterResRender(void) {
     EndTextureMode();
 }
 
-void CompositeFinalFrame(Renderer renderer, Camera3D camera, int renderedProps, int visibleProps) {
-    float w = (float)renderer.fullResTarget.texture.width;
-    float h = (float)renderer.fullResTarget.texture.height;
+void BeginGrassOitRender(Renderer renderer) {
+    BeginTextureMode(renderer.grassOitTarget);
+    rlViewport(0, 0, renderer.propsWidth, renderer.propsHeight);
+    rlEnableScissorTest();
+    rlScissor(0, 0, renderer.propsWidth, renderer.propsHeight);
+    rlDisableDepthMask(); // glClear honors the depth mask: clear only the OIT colors, keep the props depth
+    ClearBackground(BLANK);
+    rlEnableDepthMask();
+    rlDisableScissorTest();
+}
+
+void EndGrassOitRender(Renderer renderer) {
+    EndTextureMode();
+
+    // Composite over the rocks with the usual alpha blend; texelFetch maps pixels 1:1. Screen y runs
+    // down from the top of the target, so the props corner (bottom rows) starts at height - propsHeight.
+    BeginTextureMode(renderer.quarterResTarget);
+    BeginShaderMode(renderer.grassOitResolveShader);
+    SetShaderValueTexture(renderer.grassOitResolveShader,
+                          GetShaderLocation(renderer.grassOitResolveShader, "revealageTex"),
+                          renderer.grassOitRevealage);
+    Rectangle corner = { 0.0f, 0.0f, (float)renderer.propsWidth, (float)renderer.propsHeight };
+    Vector2 cornerPosition = { 0.0f, (float)(renderer.quarterResTarget.texture.height - renderer.propsHeight) };
+    DrawTextureRec(renderer.grassOitTarget.texture, corner, cornerPosition, WHITE);
+    EndShaderMode();
+    EndTextureMode();
+}
+
+void EndPropsPass(Renderer* renderer) {
+    if (renderer->propsTimerQueries[0] == 0) return;
+    rlDrawRenderBatchActive(); // Everything the pass queued must reach GL before the query ends
+    glEndQuery(GL_TIME_ELAPSED);
+    renderer->propsTimerFrame++;
+
+    // The slot the next frame reuses was issued PROPS_TIMER_QUERIES - 1 frames ago; skip it if still busy
+    if (renderer->propsTimerFrame >= PROPS_TIMER_QUERIES) {
+        GLuint query = renderer->propsTimerQueries[renderer->propsTimerFrame % PROPS_TIMER_QUERIES];
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+            float ms = (float)nanoseconds / 1.0e6f;
+            renderer->propsPassMs = (renderer->propsPassMs > 0.0f) ? renderer->propsPassMs * 0.8f + ms * 0.2f : ms;
+        }
+    }
+
+    if (!renderer->dynamicResolution || renderer->propsPassMs <= 0.0f) return;
+    if (++renderer->framesSinceScaleStep < PROPS_DYNRES_INTERVAL) return;
+    renderer->framesSinceScaleStep = 0;
+
+    // Dead band between 80% and 105% of the budget so the scale settles instead of oscillating
+    float scale = renderer->propsScale;
+    if (renderer->propsPassMs > PROPS_DYNRES_BUDGET_MS * 1.05f) scale -= PROPS_DYNRES_STEP;
+    else if (renderer->propsPassMs < PROPS_DYNRES_BUDGET_MS * 0.8f) scale += PROPS_DYNRES_STEP;
+    scale = Clamp(scale, PROPS_RENDER_SCALE_MIN, PROPS_RENDER_SCALE_MAX);
+    if (scale != renderer->propsScale) SetPropsScale(renderer, scale);
+}
+
+void SetDynamicResolution(Renderer* renderer, bool enabled) {
+    renderer->dynamicResolution = enabled;
+    renderer->framesSinceScaleStep = 0;
+    if (!enabled) SetPropsScale(renderer, renderer->propsScaleDefault);
+}
+
+void SetFusedComposite(Renderer* renderer, bool enabled) {
+    if (enabled && (!IsDofAvailable(renderer) || renderer->propsUpsampleShader.id == 0)) enabled = false;
+    renderer->fusedComposite = enabled;
+}
+
+// Color plus depth bytes of a target (LoadRenderTexture attaches a 32-bit depth renderbuffer too)
+static size_t GetTargetBytes(RenderTexture2D target, int colorBytes) {
+    if (target.id == 0) return 0;
+    return (size_t)target.texture.width * (size_t)target.texture.height * (size_t)(colorBytes + 4);
+}
+
+// Render target memory for the overlay, pooled transient targets included (Hi-Z pyramid not included)
+static float GetRenderTargetMegabytes(const Renderer* renderer) {
+    size_t bytes = GetTargetBytes(renderer->fullResTarget, 4) + GetTargetBytes(renderer->quarterResTarget, 4) +
+                   renderer->frameGraph.pooledBytes;
+    if (renderer->grassOitTarget.id != 0) {
+        // Accumulation RGBA16F + revealage R16F; the depth is quarterResTarget's
+        bytes += (size_t)renderer->grassOitTarget.texture.width * (size_t)renderer->grassOitTarget.texture.height * 10;
+    }
+    return (float)bytes / (1024.0f * 1024.0f);
+}
+
+// Merge inputs for the shaders that splice in props_merge.glsl; call inside BeginShaderMode
+static void SetPropsMergeUniforms(const Renderer* renderer, Shader shader) {
+    Vector2 propsSize = { (float)renderer->propsWidth, (float)renderer->propsHeight };
+    float nearPlane = (float)rlGetCullDistanceNear();
+    float farPlane = (float)rlGetCullDistanceFar();
+    float tolerance = PROPS_UPSAMPLE_DEPTH_TOLERANCE;
+    SetShaderValueTexture(shader, GetShaderLocation(shader, "sceneDepth"), renderer->fullResTarget.depth);
+    SetShaderValueTexture(shader, GetShaderLocation(shader, "propsColor"), renderer->quarterResTarget.texture);
+    SetShaderValueTexture(shader, GetShaderLocation(shader, "propsDepth"), renderer->quarterResTarget.depth);
+    SetShaderValue(shader, GetShaderLocation(shader, "propsSize"), &propsSize, SHADER_UNIFORM_VEC2);
+    SetShaderValue(shader, GetShaderLocation(shader, "nearPlane"), &nearPlane, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(shader, GetShaderLocation(shader, "farPlane"), &farPlane, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(shader, GetShaderLocation(shader, "depthTolerance"), &tolerance, SHADER_UNIFORM_FLOAT);
+}
+
+// Blending off for the draws until EndOpaqueDraw: the alpha written carries data (props coverage, blur
+// amount), not opacity. Both flush the batch, which also drops the textures bound by SetShaderValueTexture,
+// so bind a pass's textures after BeginOpaqueDraw.
+static void BeginOpaqueDraw(void) {
+    rlDrawRenderBatchActive();
+    rlDisableColorBlend();
+}
+
+static void EndOpaqueDraw(void) {
+    rlDrawRenderBatchActive();
+    rlEnableColorBlend();
+}
+
+// rlgl's batch owns texture units 0..RL_DEFAULT_BATCH_MAX_TEXTURE_UNITS, so the tile map is bound past them
+static void BindDofTiles(const FrameGraph* graph, const Renderer* renderer, Shader shader, float tileScale) {
+    int unit = DOF_TILE_TEXTURE_UNIT;
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, GetFrameTarget(graph, renderer->post.dofTiles).texture.id);
+    glActiveTexture(GL_TEXTURE0);
+    SetShaderValue(shader, GetShaderLocation(shader, "dofTiles"), &unit, SHADER_UNIFORM_INT);
+    SetShaderValue(shader, GetShaderLocation(shader, "tileScale"), &tileScale, SHADER_UNIFORM_FLOAT);
+}
+
+// Copy a finished tile map readback into the histogram; leaves the slot pending if the GPU is not done yet
+static void CollectDofTileReadback(Renderer* renderer, int slot, int count) {
+    GLsync fence = (GLsync)renderer->dofTileFence[slot];
+    if (fence == NULL) return;
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return;
+    glDeleteSync(fence);
+    renderer->dofTileFence[slot] = NULL;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, renderer->dofTilePbo[slot]);
+    const unsigned char* classes = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, count, GL_MAP_READ_BIT);
+    if (classes != NULL) {
+        for (int c = 0; c < DOF_TILE_CLASS_COUNT; c++) renderer->dofTileCounts[c] = 0;
+        // The tile pass writes class / 2 (0, 128, 255)
+        for (int i = 0; i < count; i++) renderer->dofTileCounts[(classes[i] + 64) / 128]++;
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+// Pass: props over the scene into the composite target (DOF off, or the separate path)
+static void PropsMergePass(FrameGraph* graph, void* userData) {
+    Renderer* renderer = (Renderer*)userData;
+    float w = (float)renderer->fullResTarget.texture.width;
+    float h = (float)renderer->fullResTarget.texture.height;
     Rectangle fullFlipped = { 0.0f, 0.0f, w, -h };
-    Rectangle propsFlipped = { 0.0f, 0.0f, (float)renderer.quarterResTarget.texture.width, (float)-renderer.quarterResTarget.texture.height };
+    Rectangle propsFlipped = { 0.0f, 0.0f, (float)renderer->propsWidth, (float)-renderer->propsHeight };
     Rectangle destFull = { 0.0f, 0.0f, w, h };
 
-    BeginTextureMode(renderer.compositeTarget);
+    BeginTextureMode(GetFrameTarget(graph, renderer->post.composite));
     ClearBackground(BLACK);
-    DrawTextureRec(renderer.fullResTarget.texture, fullFlipped, (Vector2){ 0.0f, 0.0f }, WHITE);
-    DrawTexturePro(renderer.quarterResTarget.texture, propsFlipped, destFull, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+    if (renderer->propsUpsampleShader.id != 0) {
+        // One pass writes the merged colour and the props coverage, so blending must not touch it
+        BeginShaderMode(renderer->propsUpsampleShader);
+        BeginOpaqueDraw();
+        SetPropsMergeUniforms(renderer, renderer->propsUpsampleShader);
+        DrawTexturePro(renderer->fullResTarget.texture, fullFlipped, destFull, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+        EndOpaqueDraw();
+        EndShaderMode();
+    } else {
+        DrawTextureRec(renderer->fullResTarget.texture, fullFlipped, (Vector2){ 0.0f, 0.0f }, WHITE);
+        DrawTexturePro(renderer->quarterResTarget.texture, propsFlipped, destFull, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+    }
     EndTextureMode();
+}
 
-    if (renderer.dofBlurShader.id != 0 && renderer.dofCompositeShader.id != 0) {
-        float scale = DOF_GAUSSIAN_PIXEL_SCALE;
-        Vector2 texelH = { scale / w, 0.0f };
-        Vector2 texelV = { 0.0f, scale / h };
-        int locBlurImage = GetShaderLocation(renderer.dofBlurShader, "image");
-        int locBlurDir = GetShaderLocation(renderer.dofBlurShader, "texelDir");
-
-        BeginTextureMode(renderer.blurPing);
-        ClearBackground(BLANK);
-        BeginShaderMode(renderer.dofBlurShader);
-        SetShaderValueTexture(renderer.dofBlurShader, locBlurImage, renderer.compositeTarget.texture);
-        SetShaderValue(renderer.dofBlurShader, locBlurDir, &texelH, SHADER_UNIFORM_VEC2);
-        DrawTextureRec(renderer.compositeTarget.texture, fullFlipped, (Vector2){ 0.0f, 0.0f }, WHITE);
-        EndShaderMode();
-        EndTextureMode();
+// Pass: classify DOF_TILE_SIZE tiles by the depth range inside them and start an async readback for the overlay
+static void DofTilesPass(FrameGraph* graph, void* userData) {
+    Renderer* renderer = (Renderer*)userData;
+    Camera3D camera = renderer->post.camera;
+    Shader shader = renderer->dofTileShader;
+    RenderTexture2D target = GetFrameTarget(graph, renderer->post.dofTiles);
+    Texture2D tiles = target.texture;
+    float fullW = (float)renderer->fullResTarget.texture.width;
+    float fullH = (float)renderer->fullResTarget.texture.height;
+    // Distance bounds come from view depth, which only holds for perspective; anything else blurs everywhere
+    float classify = (camera.projection == CAMERA_PERSPECTIVE) ? 1.0f : 0.0f;
+    float tanY = tanf(camera.fovy * DEG2RAD * 0.5f);
+    Vector2 tanHalfFov = { tanY * fullW / fullH, tanY };
+    float sharpR = DOF_SHARP_RADIUS_M;
+    float blurFull = DOF_BLUR_FULL_DIST_M;
+    int tileSize = DOF_TILE_SIZE;
+
+    BeginTextureMode(target);
+    BeginShaderMode(shader);
+    BeginOpaqueDraw();
+    SetPropsMergeUniforms(renderer, shader);
+    SetShaderValue(shader, GetShaderLocation(shader, "classifyTiles"), &classify, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(shader, GetShaderLocation(shader, "tanHalfFov"), &tanHalfFov, SHADER_UNIFORM_VEC2);
+    SetShaderValue(shader, GetShaderLocation(shader, "dofSharpRadiusM"), &sharpR, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(shader, GetShaderLocation(shader, "dofBlurFullDistM"), &blurFull, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(shader, GetShaderLocation(shader, "tileSize"), &tileSize, SHADER_UNIFORM_INT);
+    // The shader works from gl_FragCoord, so any quad that covers the map will do
+    DrawRectangle(0, 0, tiles.width, tiles.height, WHITE);
+    EndOpaqueDraw();
+    EndShaderMode();
+
+    if (renderer->dofTilePbo[0] != 0) {
+        int slot = renderer->dofTileWriteSlot;
+        CollectDofTileReadback(renderer, (slot + 1) % DOF_TILE_READBACK_SLOTS, tiles.width * tiles.height);
+        if (renderer->dofTileFence[slot] == NULL) {
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, renderer->dofTilePbo[slot]);
+            glReadPixels(0, 0, tiles.width, tiles.height, GL_RED, GL_UNSIGNED_BYTE, NULL);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            glPixelStorei(GL_PACK_ALIGNMENT, 4);
+            renderer->dofTileFence[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            renderer->dofTileWriteSlot = (slot + 1) % DOF_TILE_READBACK_SLOTS;
+        }
+    }
+    EndTextureMode();
+}
 
-        BeginTextureMode(renderer.blurPong);
-        ClearBackground(BLANK);
-        BeginShaderMode(renderer.dofBlurShader);
-        SetShaderValueTexture(renderer.dofBlurShader, locBlurImage, renderer.blurPing.texture);
-        SetShaderValue(renderer.dofBlurShader, locBlurDir, &texelV, SHADER_UNIFORM_VEC2);
-        DrawTextureRec(renderer.blurPing.texture, fullFlipped, (Vector2){ 0.0f, 0.0f }, WHITE);
-        EndShaderMode();
+// Inputs shared by the shaders that turn depth into a blur amount (dof_downsample.fs, dof_composite.fs);
+// call inside BeginShaderMode. The sharp frame is the drawn texture (texture0), which keeps the composite
+// within the batch's four extra texture units. Fused, it is fullResTarget and the props merge in the shader.
+static void SetDofDepthUniforms(const Renderer* renderer, Shader shader) {
+    Camera3D camera = renderer->post.camera;
+    int w = renderer->fullResTarget.texture.width;
+    int h = renderer->fullResTarget.texture.height;
+    float fused = renderer->post.fused ? 1.0f : 0.0f;
+    SetPropsMergeUniforms(renderer, shader);
+    SetShaderValue(shader, GetShaderLocation(shader, "fusedComposite"), &fused, SHADER_UNIFORM_FLOAT);
+    Matrix invVP = DofInvViewProj(camera, w, h);
+    Vector3 camPos = camera.position;
+    float sharpR = DOF_SHARP_RADIUS_M;
+    float blurFull = DOF_BLUR_FULL_DIST_M;
+    SetShaderValueMatrix(shader, GetShaderLocation(shader, "invViewProj"), invVP);
+    SetShaderValue(shader, GetShaderLocation(shader, "camPos"), &camPos, SHADER_UNIFORM_VEC3);
+    SetShaderValue(shader, GetShaderLocation(shader, "dofSharpRadiusM"), &sharpR, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(shader, GetShaderLocation(shader, "dofBlurFullDistM"), &blurFull, SHADER_UNIFORM_FLOAT);
+    // Props live in the bottom-left propsWidth x propsHeight texels; stay half a texel inside so
+    // bilinear taps never reach stale texels outside it
+    float qw = (float)renderer->quarterResTarget.texture.width;
+    float qh = (float)renderer->quarterResTarget.texture.height;
+    Vector2 propsUvScale = { (float)renderer->propsWidth / qw, (float)renderer->propsHeight / qh };
+    Vector2 propsUvMax = { ((float)renderer->propsWidth - 0.5f) / qw, ((float)renderer->propsHeight - 0.5f) / qh };
+    SetShaderValue(shader, GetShaderLocation(shader, "propsUvScale"), &propsUvScale, SHADER_UNIFORM_VEC2);
+    SetShaderValue(shader, GetShaderLocation(shader, "propsUvMax"), &propsUvMax, SHADER_UNIFORM_VEC2);
+    float coverageInSharpAlpha = (renderer->propsUpsampleShader.id != 0) ? 1.0f : 0.0f;
+    SetShaderValue(shader, GetShaderLocation(shader, "coverageInSharpAlpha"), &coverageInSharpAlpha, SHADER_UNIFORM_FLOAT);
+}
+
+// Sharp frame the DOF passes draw: fused, the scene (props merged in the shader); otherwise the composite
+static Texture2D GetDofSharpTexture(const FrameGraph* graph, const Renderer* renderer) {
+    if (renderer->post.fused) return renderer->fullResTarget.texture;
+    return GetFrameTarget(graph, renderer->post.composite).texture;
+}
+
+// Pass: first chain level; also turns depth into the blur amount. Sharp tiles skip it.
+static void DofDownsamplePass(FrameGraph* graph, void* userData) {
+    Renderer* renderer = (Renderer*)userData;
+    Shader shader = renderer->dofDownsampleShader;
+    RenderTexture2D first = GetFrameTarget(graph, renderer->post.dofChain[0]);
+    float w = (float)renderer->fullResTarget.texture.width;
+    float h = (float)renderer->fullResTarget.texture.height;
+
+    BeginTextureMode(first);
+    BeginShaderMode(shader);
+    BeginOpaqueDraw();
+    SetDofDepthUniforms(renderer, shader);
+    BindDofTiles(graph, renderer, shader, 1.0f / (float)DOF_TILE_SIZE);
+    DrawTexturePro(GetDofSharpTexture(graph, renderer), (Rectangle){ 0.0f, 0.0f, w, -h },
+                   (Rectangle){ 0.0f, 0.0f, (float)first.texture.width, (float)first.texture.height },
+                   (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+    EndOpaqueDraw();
+    EndShaderMode();
+    EndTextureMode();
+}
+
+// Pass: deeper chain levels, each a single bilinear tap of the one above (a 2x2 average)
+static void DofChainPass(FrameGraph* graph, void* userData) {
+    Renderer* renderer = (Renderer*)userData;
+    for (int level = 1; level < DOF_BLUR_LEVELS; level++) {
+        Texture2D source = GetFrameTarget(graph, renderer->post.dofChain[level - 1]).texture;
+        RenderTexture2D dest = GetFrameTarget(graph, renderer->post.dofChain[level]);
+        BeginTextureMode(dest);
+        BeginOpaqueDraw();
+        DrawTexturePro(source, (Rectangle){ 0.0f, 0.0f, (float)source.width, (float)-source.height },
+                       (Rectangle){ 0.0f, 0.0f, (float)dest.texture.width, (float)dest.texture.height }, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+        EndOpaqueDraw();
         EndTextureMode();
     }
+}
+
+// One direction of the separable Gaussian at the last chain level. The tap step is in level texels, so
+// the radius on screen doesn't depend on the chain depth.
+static void DrawDofBlur(const FrameGraph* graph, const Renderer* renderer, int source, int dest, bool vertical) {
+    Shader shader = renderer->dofBlurShader;
+    Texture2D image = GetFrameTarget(graph, source).texture;
+    float bw = (float)image.width;
+    float bh = (float)image.height;
+    float step = DOF_BLUR_RADIUS_PX / (float)(1 << DOF_BLUR_LEVELS) / 4.0f;
+    Vector2 texelDir = vertical ? (Vector2){ 0.0f, step / bh } : (Vector2){ step / bw, 0.0f };
+
+    BeginTextureMode(GetFrameTarget(graph, dest));
+    BeginShaderMode(shader);
+    BeginOpaqueDraw();
+    SetShaderValueTexture(shader, GetShaderLocation(shader, "image"), image);
+    SetShaderValue(shader, GetShaderLocation(shader, "texelDir"), &texelDir, SHADER_UNIFORM_VEC2);
+    BindDofTiles(graph, renderer, shader, (float)(1 << DOF_BLUR_LEVELS) / (float)DOF_TILE_SIZE);
+    DrawTexturePro(image, (Rectangle){ 0.0f, 0.0f, bw, -bh }, (Rectangle){ 0.0f, 0.0f, bw, bh }, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+    EndOpaqueDraw();
+    EndShaderMode();
+    EndTextureMode();
+}
+
+// Pass: horizontal blur of the last chain level into blurPing
+static void DofBlurHPass(FrameGraph* graph, void* userData) {
+    Renderer* renderer = (Renderer*)userData;
+    DrawDofBlur(graph, renderer, renderer->post.dofChain[DOF_BLUR_LEVELS - 1], renderer->post.blurPing, false);
+}
+
+// Pass: vertical blur of blurPing into the blurred target
+static void DofBlurVPass(FrameGraph* graph, void* userData) {
+    Renderer* renderer = (Renderer*)userData;
+    DrawDofBlur(graph, renderer, renderer->post.blurPing, renderer->post.blurred, true);
+}
+
+// Pass: composite to the screen and draw the overlay
+static void PresentPass(FrameGraph* graph, void* userData) {
+    Renderer* renderer = (Renderer*)userData;
+    const PostPassFrame* post = &renderer->post;
+    const FrameStats* stats = post->stats;
+    float w = (float)renderer->fullResTarget.texture.width;
+    float h = (float)renderer->fullResTarget.texture.height;
+    Rectangle fullFlipped = { 0.0f, 0.0f, w, -h };
 
     BeginDrawing();
     ClearBackground(BLACK);
 
-    if (renderer.dofBlurShader.id == 0 || renderer.dofCompositeShader.id == 0) {
-        DrawTextureRec(renderer.compositeTarget.texture, fullFlipped, (Vector2){ 0.0f, 0.0f }, WHITE);
+    if (!post->dof) {
+        // The composite's alpha is props coverage when upsampled, not opacity
+        BeginOpaqueDraw();
+        DrawTexturePro(GetFrameTarget(graph, post->composite).texture, fullFlipped, (Rectangle){ 0.0f, 0.0f, w, h },
+                       (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+        EndOpaqueDraw();
     } else {
-        BeginShaderMode(renderer.dofCompositeShader);
-        int locSharp = GetShaderLocation(renderer.dofCompositeShader, "sharpTex");
-        int locBlur = GetShaderLocation(renderer.dofCompositeShader, "blurTex");
-        int locDs = GetShaderLocation(renderer.dofCompositeShader, "depthScene");
-        int locDp = GetShaderLocation(renderer.dofCompositeShader, "depthProps");
-        int locPc = GetShaderLocation(renderer.dofCompositeShader, "propsColorTex");
-        int locInvVP = GetShaderLocation(renderer.dofCompositeShader, "invViewProj");
-        int locCam = GetShaderLocation(renderer.dofCompositeShader, "camPos");
-        int locSharpR = GetShaderLocation(renderer.dofCompositeShader, "dofSharpRadiusM");
-        int locBlurFull = GetShaderLocation(renderer.dofCompositeShader, "dofBlurFullDistM");
-        SetShaderValueTexture(renderer.dofCompositeShader, locSharp, renderer.compositeTarget.texture);
-        SetShaderValueTexture(renderer.dofCompositeShader, locBlur, renderer.blurPong.texture);
-        SetShaderValueTexture(renderer.dofCompositeShader, locDs, renderer.fullResTarget.depth);
-        SetShaderValueTexture(renderer.dofCompositeShader, locDp, renderer.quarterResTarget.depth);
-        SetShaderValueTexture(renderer.dofCompositeShader, locPc, renderer.quarterResTarget.texture);
-        Matrix invVP = DofInvViewProj(camera, (int)w, (int)h);
-        Vector3 camPos = camera.position;
-        float sharpR = DOF_SHARP_RADIUS_M;
-        float blurFull = DOF_BLUR_FULL_DIST_M;
-        SetShaderValueMatrix(renderer.dofCompositeShader, locInvVP, invVP);
-        SetShaderValue(renderer.dofCompositeShader, locCam, &camPos, SHADER_UNIFORM_VEC3);
-        SetShaderValue(renderer.dofCompositeShader, locSharpR, &sharpR, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(renderer.dofCompositeShader, locBlurFull, &blurFull, SHADER_UNIFORM_FLOAT);
-        DrawTextureRec(renderer.compositeTarget.texture, fullFlipped, (Vector2){ 0.0f, 0.0f }, WHITE);
+        Shader shader = renderer->dofCompositeShader;
+        BeginShaderMode(shader);
+        SetDofDepthUniforms(renderer, shader);
+        SetShaderValueTexture(shader, GetShaderLocation(shader, "blurTex"), GetFrameTarget(graph, post->blurred).texture);
+        BindDofTiles(graph, renderer, shader, 1.0f / (float)DOF_TILE_SIZE);
+        DrawTextureRec(GetDofSharpTexture(graph, renderer), fullFlipped, (Vector2){ 0.0f, 0.0f }, WHITE);
         EndShaderMode();
     }
 
     DrawFPS(10, 10);
     DrawText(TextFormat("Rendered Props: %d/%d (%.1f%%)",
-             renderedProps, visibleProps,
-             visibleProps > 0 ? (float)renderedProps / visibleProps * 100.0f : 0),
+             stats->renderedProps, stats->visibleProps,
+             stats->visibleProps > 0 ? (float)stats->renderedProps / stats->visibleProps * 100.0f : 0),
              10, 40, 20, WHITE);
+    DrawText(TextFormat("LOS: %s, oldest pending %.0f ms",
+             stats->losTimeSliced ? "time-sliced" : "full", stats->losOldestPendingMs),
+             10, 65, 20, WHITE);
+    if (stats->grassOit) {
+        DrawText(TextFormat("Grass: weighted blended OIT, sort-free (saves ~%.2f ms, est.)", stats->grassFullSortMs), 10, 90, 20, WHITE);
+    } else {
+        DrawText(TextFormat("Grass: sorted, %.2f ms (full sort %.2f ms)", stats->grassSortMs, stats->grassFullSortMs), 10, 90, 20, WHITE);
+    }
+    if (stats->occlusionCulling) {
+        DrawText(TextFormat("Hi-Z: %d props occluded", stats->occludedProps), 10, 115, 20, WHITE);
+    } else {
+        DrawText("Hi-Z: off", 10, 115, 20, WHITE);
+    }
+    if (stats->terrainNodes > 0) {
+        DrawText(TextFormat("Terrain: %d CDLOD nodes, %d triangles", stats->terrainNodes, stats->terrainTriangles), 10, 140, 20, WHITE);
+    }
+    DrawText(TextFormat("World: %d tiles resident, %d pending, %d props", stats->residentTiles, stats->pendingTiles,
+             stats->residentProps), 10, 165, 20, WHITE);
+    DrawText(TextFormat("Props pass: %dx%d, %.2f ms GPU (%s)", stats->propsWidth, stats->propsHeight, stats->propsPassMs,
+             stats->dynamicResolution ? "dynamic" : "fixed"), 10, 190, 20, WHITE);
+    DrawText(TextFormat("Composite: %s, render targets %.1f MB (%d pooled)", post->fused ? "fused" : "separate",
+             GetRenderTargetMegabytes(renderer), graph->pooledTargets), 10, 215, 20, WHITE);
+    if (post->dof) {
+        DrawText(TextFormat("DOF tiles (%dpx): %d sharp, %d transition, %d blurred", DOF_TILE_SIZE,
+                 renderer->dofTileCounts[DOF_TILE_SHARP], renderer->dofTileCounts[DOF_TILE_TRANSITION],
+                 renderer->dofTileCounts[DOF_TILE_BLURRED]), 10, 240, 20, WHITE);
+    } else {
+        DrawText("DOF: off", 10, 240, 20, WHITE);
+    }
+    DrawText(TextFormat("Frame graph: %d passes, %d culled", graph->passCount, graph->culledCount), 10, 265, 20, WHITE);
 
     EndDrawing();
 }
 
+void AddPostPasses(Renderer* renderer, int sceneTarget, int propsTarget, Camera3D camera, const FrameStats* stats) {
+    FrameGraph* graph = &renderer->frameGraph;
+    PostPassFrame* post = &renderer->post;
+    int w = renderer->fullResTarget.texture.width;
+    int h = renderer->fullResTarget.texture.height;
+    bool dofAvailable = IsDofAvailable(renderer);
+    *post = (PostPassFrame){ .camera = camera, .stats = stats, .scene = sceneTarget, .props = propsTarget,
+                             .dofTiles = -1, .blurPing = -1, .blurred = -1 };
+    post->dof = dofAvailable && renderer->dofEnabled;
+    post->fused = post->dof && renderer->fusedComposite;
+
+    // Every pass is declared each frame; what the present pass doesn't need (the merge while fused, the
+    // DOF passes while DOF is off) is culled along with its targets
+    post->composite = CreateFrameTarget(graph, "composite", w, h, MAIN_TEXTURE_FILTER_MODE);
+    int pass = AddFramePass(graph, "propsMerge", PropsMergePass, renderer);
+    FrameRead(graph, pass, sceneTarget);
+    FrameRead(graph, pass, propsTarget);
+    FrameWrite(graph, pass, post->composite);
+
+    if (dofAvailable) {
+        post->dofTiles = CreateFrameTarget(graph, "dofTiles", (w + DOF_TILE_SIZE - 1) / DOF_TILE_SIZE,
+                                           (h + DOF_TILE_SIZE - 1) / DOF_TILE_SIZE, TEXTURE_FILTER_POINT);
+        pass = AddFramePass(graph, "dofTiles", DofTilesPass, renderer);
+        FrameRead(graph, pass, sceneTarget);
+        FrameRead(graph, pass, propsTarget);
+        FrameWrite(graph, pass, post->dofTiles);
+
+        for (int level = 0; level < DOF_BLUR_LEVELS; level++) {
+            post->dofChain[level] = CreateFrameTarget(graph, DOF_CHAIN_NAMES[level], w >> (level + 1), h >> (level + 1),
+                                                      TEXTURE_FILTER_BILINEAR);
+        }
+        pass = AddFramePass(graph, "dofDownsample", DofDownsamplePass, renderer);
+        FrameRead(graph, pass, sceneTarget);
+        FrameRead(graph, pass, propsTarget);
+        if (!post->fused) FrameRead(graph, pass, post->composite);
+        FrameRead(graph, pass, post->dofTiles);
+        FrameWrite(graph, pass, post->dofChain[0]);
+        if (DOF_BLUR_LEVELS > 1) {
+            pass = AddFramePass(graph, "dofChain", DofChainPass, renderer);
+            for (int level = 1; level < DOF_BLUR_LEVELS; level++) {
+                FrameRead(graph, pass, post->dofChain[level - 1]);
+                FrameWrite(graph, pass, post->dofChain[level]);
+            }
+        }
+
+        // The vertical pass writes a new target rather than the chain level it started from, so the
+        // graph can hand it the level's texture once the horizontal pass is done with it
+        int last = post->dofChain[DOF_BLUR_LEVELS - 1];
+        int bw = w >> DOF_BLUR_LEVELS;
+        int bh = h >> DOF_BLUR_LEVELS;
+        post->blurPing = CreateFrameTarget(graph, "blurPing", bw, bh, TEXTURE_FILTER_BILINEAR);
+        post->blurred = CreateFrameTarget(graph, "dofBlurred", bw, bh, TEXTURE_FILTER_BILINEAR);
+        pass = AddFramePass(graph, "dofBlurH", DofBlurHPass, renderer);
+        FrameRead(graph, pass, last);
+        FrameRead(graph, pass, post->dofTiles);
+        FrameWrite(graph, pass, post->blurPing);
+        pass = AddFramePass(graph, "dofBlurV", DofBlurVPass, renderer);
+        FrameRead(graph, pass, post->blurPing);
+        FrameRead(graph, pass, post->dofTiles);
+        FrameWrite(graph, pass, post->blurred);
+    }
+
+    pass = AddFramePass(graph, "present", PresentPass, renderer);
+    SetFramePassSideEffect(graph, pass);
+    if (post->dof) {
+        FrameRead(graph, pass, sceneTarget);
+        FrameRead(graph, pass, propsTarget);
+        FrameRead(graph, pass, post->blurred);
+        FrameRead(graph, pass, post->dofTiles);
+        if (!post->fused) FrameRead(graph, pass, post->composite);
+    } else {
+        FrameRead(graph, pass, post->composite);
+    }
+}
+
 void UnloadRenderer(Renderer renderer) {
     if (renderer.hasSkybox) {
         UnloadModel(renderer.skyboxModel);
         UnloadShader(renderer.skyboxShader);
     }
+    if (renderer.grassOitTarget.id != 0) {
+        // Shares quarterResTarget's depth: detach it so only quarterResTarget deletes it
+        rlFramebufferAttach(renderer.grassOitTarget.id, 0, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_TEXTURE2D, 0);
+        rlUnloadFramebuffer(renderer.grassOitTarget.id);
+        UnloadTexture(renderer.grassOitTarget.texture);
+        UnloadTexture(renderer.grassOitRevealage);
+    }
+    UnloadShader(renderer.grassOitResolveShader);
+    if (renderer.propsTimerQueries[0] != 0) glDeleteQueries(PROPS_TIMER_QUERIES, renderer.propsTimerQueries);
+    UnloadHiZPyramid(&renderer.hiz);
     UnloadRenderTexture(renderer.fullResTarget);
     UnloadRenderTexture(renderer.quarterResTarget);
-    UnloadRenderTexture(renderer.compositeTarget);
-    UnloadRenderTexture(renderer.blurPing);
-    UnloadRenderTexture(renderer.blurPong);
+    UnloadFrameGraph(&renderer.frameGraph);
+    UnloadShader(renderer.propsUpsampleShader);
+    UnloadShader(renderer.dofDownsampleShader);
     UnloadShader(renderer.dofBlurShader);
+    for (int slot = 0; slot < DOF_TILE_READBACK_SLOTS; slot++) {
+        if (renderer.dofTileFence[slot] != NULL) glDeleteSync((GLsync)renderer.dofTileFence[slot]);
+    }
+    if (renderer.dofTilePbo[0] != 0) glDeleteBuffers(DOF_TILE_READBACK_SLOTS, renderer.dofTilePbo);
+    UnloadShader(renderer.dofTileShader);
     UnloadShader(renderer.dofCompositeShader);
     UnloadShader(renderer.lightingShader);
+    UnloadShader(renderer.lightingInstancedShader);
+    UnloadShader(renderer.terrainShader);
 }
@@ -4,17 +4,87 @@
 #include "common.h"
 #include "scene.h"
 #include "props.h"
+#include "hiz.h"
+#include "framegraph.h"
+
+// DOF tile classes, from the depth range inside each DOF_TILE_SIZE tile
+typedef enum {
+    DOF_TILE_SHARP,      // Entirely within DOF_SHARP_RADIUS_M: passes through unblurred
+    DOF_TILE_TRANSITION, // Per-pixel blur amount
+    DOF_TILE_BLURRED,    // Entirely beyond DOF_BLUR_FULL_DIST_M: blurred without per-pixel depth work
+    DOF_TILE_CLASS_COUNT
+} DofTileClass;
+
+// Numbers shown by the stats overlay in the present pass
+typedef struct {
+    int renderedProps;
+    int visibleProps;
+    bool losTimeSliced;        // LOS mode (F2)
+    float losOldestPendingMs;  // Oldest LOS result awaiting a re-check
+    bool grassOit;             // Grass mode (F3): weighted blended OIT instead of the sort
+    float grassSortMs;         // Grass sort time this frame (near 0 when the sort was skipped)
+    float grassFullSortMs;     // Last full sort, or OIT's periodic scratch sort: what OIT saves
+    bool occlusionCulling;     // Hi-Z occlusion culling (F4)
+    int occludedProps;         // Props rejected by the Hi-Z test this frame
+    int terrainNodes;          // CDLOD nodes drawn (0 = coarse single-mesh fallback)
+    int terrainTriangles;
+    int residentTiles;         // Streamed world tiles in the resident window
+    int pendingTiles;          // Window tiles still being generated
+    int residentProps;
+    int propsWidth;            // Props viewport this frame
+    int propsHeight;
+    float propsPassMs;         // GPU time of the props pass
+    bool dynamicResolution;    // F5
+} FrameStats;
+
+// This frame's post pass inputs and frame graph handles, filled by AddPostPasses for its pass callbacks
+typedef struct {
+    Camera3D camera;
+    const FrameStats* stats;   // Read when the present pass runs, after the props passes filled it
+    int scene;                 // Imported fullResTarget / quarterResTarget
+    int props;
+    int composite;             // Separate props merge (full res)
+    int dofTiles;              // One texel per DOF_TILE_SIZE tile, DofTileClass / 2 in red
+    int dofChain[DOF_BLUR_LEVELS]; // 1/2, 1/4, ... res: colour + blur amount
+    int blurPing;              // Horizontal blur, sized like the last chain level
+    int blurred;               // Vertical blur, read by the present pass
+    bool dof;                  // Present composites the blur (otherwise the DOF passes are culled)
+    bool fused;                // DOF passes merge props over the scene themselves (composite is culled)
+} PostPassFrame;
 
 // Renderer context
 typedef struct {
     RenderTexture2D fullResTarget;
-    RenderTexture2D quarterResTarget;
-    RenderTexture2D compositeTarget; // sharp color: scene + props
-    RenderTexture2D blurPing;
-    RenderTexture2D blurPong;
+    RenderTexture2D quarterResTarget; // Allocated at PROPS_RENDER_SCALE_MAX; props use the propsWidth x propsHeight corner
     Shader lightingShader;         // Lighting shader
+    Shader lightingInstancedShader; // Same lighting with per-instance transforms (rocks)
+    Shader terrainShader;           // Same lighting on CDLOD terrain nodes displaced from a height texture
+    RenderTexture2D grassOitTarget; // texture = RGBA16F accumulation; depth = quarterResTarget.depth (shared)
+    Texture2D grassOitRevealage;    // R16F sum of -log(1 - alpha), second color attachment
+    Shader grassOitResolveShader;
+    HiZPyramid hiz;                 // Farthest-depth pyramid of fullResTarget for prop occlusion culling
+    Shader propsUpsampleShader;     // Depth-aware props upsample into the composite target (id 0 = bilinear stretch)
+    Shader dofDownsampleShader;
     Shader dofBlurShader;
     Shader dofCompositeShader;
+    Shader dofTileShader;
+    unsigned int dofTilePbo[DOF_TILE_READBACK_SLOTS]; // Async readback of the tile map for the overlay
+    void* dofTileFence[DOF_TILE_READBACK_SLOTS];      // GLsync; NULL = slot idle
+    int dofTileWriteSlot;
+    int dofTileCounts[DOF_TILE_CLASS_COUNT];          // Tile histogram of the last finished readback
+    float propsScale;               // Current props render scale
+    float propsScaleDefault;        // Fixed scale while dynamic resolution is off
+    int propsWidth;                 // Props viewport inside quarterResTarget (bottom-left corner)
+    int propsHeight;
+    bool fusedComposite;            // DOF passes merge props over fullResTarget themselves, no composite target (F6)
+    bool dofEnabled;                // Present through the DOF blur (F7)
+    FrameGraph frameGraph;          // Passes of the frame being drawn; owns the pooled transient targets
+    PostPassFrame post;
+    bool dynamicResolution;         // Step propsScale to hold PROPS_DYNRES_BUDGET_MS (F5)
+    float propsPassMs;              // Smoothed GPU time of the props pass (0 until the first result)
+    unsigned int propsTimerQueries[PROPS_TIMER_QUERIES]; // GL_TIME_ELAPSED ring (0 = no timing)
+    int propsTimerFrame;
+    int framesSinceScaleStep;
     Vector3 lightPosition;         // Light position
     Shader skyboxShader;
     Model skyboxModel;
@@ -33,14 +103,35 @@ void BeginFullResRender(Renderer renderer);
 // End drawing to full resolution target
 void EndFullResRender(void);
 
-// Begin drawing to quarter resolution target
+// Build the Hi-Z pyramid from the finished full-res depth and start its readback (call after EndFullResRender)
+void UpdateSceneOcclusion(Renderer* renderer, Camera3D camera);
+
+// Begin drawing to quarter resolution target (viewport = the current props scale) and start the props pass timer
 void BeginQuarterResRender(Renderer renderer);
 
 // End drawing to quarter resolution target
 void EndQuarterResRender(void);
 
-// Composite both render targets to screen (camera used for world-space DOF distance)
-void CompositeFinalFrame(Renderer renderer, Camera3D camera, int renderedProps, int visibleProps);
+// Weighted blended OIT pass for grass: binds and clears the accumulation targets (props depth is kept)
+void BeginGrassOitRender(Renderer renderer);
+
+// Resolve the OIT targets over the props in quarterResTarget
+void EndGrassOitRender(Renderer renderer);
+
+// Stop the props pass timer (after grass OIT), collect a finished timing and, with dynamic resolution on,
+// step the props scale for the next frame
+void EndPropsPass(Renderer* renderer);
+
+// Toggle dynamic props resolution; turning it off restores the startup scale
+void SetDynamicResolution(Renderer* renderer, bool enabled);
+
+// Toggle the fused composite (needs the DOF and props upsample shaders); fused, the graph culls the separate merge
+void SetFusedComposite(Renderer* renderer, bool enabled);
+
+// Declare the passes that take the scene and props targets to the screen: props merge, DOF tiles, chain
+// and blur, and the present pass that composites and draws the overlay from *stats (camera used for
+// world-space DOF distance). Call after the passes writing sceneTarget and propsTarget are declared.
+void AddPostPasses(Renderer* renderer, int sceneTarget, int propsTarget, Camera3D camera, const FrameStats* stats);
 
 // Unload renderer resources
 void UnloadRenderer(Renderer renderer);
@@ -1,20 +1,34 @@
 #version 330 core
+// Separable 9-tap Gaussian on the last level of the DOF chain. Alpha holds each texel's blur amount;
+// taps are weighted by it so in-focus pixels don't smear into the blurred background around them.
+// Alpha passes through unblurred for the depth-aware upsample.
 in vec2 fragTexCoord;
 out vec4 fragColor;
 uniform sampler2D image;
-uniform vec2 texelDir; // (1/w,0) or (0,1/h) times optional strength
+uniform vec2 texelDir; // One tap step in UV along x or y (DOF_BLUR_RADIUS_PX spread over 4 steps)
+uniform sampler2D dofTiles; // dof_tiles.fs classes; sharp tiles pass their texel through unblurred
+uniform float tileScale;    // Tiles per texel of this level
+
+const float weights[5] = float[5](0.2270270270, 0.1945945946, 0.1216216216, 0.0540540541, 0.0162162162);
 
 void main()
 {
     vec2 uv = fragTexCoord;
-    vec3 c = texture(image, uv).rgb * 0.2270270270;
-    c += texture(image, uv + texelDir * 1.0).rgb * 0.1945945946;
-    c += texture(image, uv - texelDir * 1.0).rgb * 0.1945945946;
-    c += texture(image, uv + texelDir * 2.0).rgb * 0.1216216216;
-    c += texture(image, uv - texelDir * 2.0).rgb * 0.1216216216;
-    c += texture(image, uv + texelDir * 3.0).rgb * 0.0540540541;
-    c += texture(image, uv - texelDir * 3.0).rgb * 0.0540540541;
-    c += texture(image, uv + texelDir * 4.0).rgb * 0.0162162162;
-    c += texture(image, uv - texelDir * 4.0).rgb * 0.0162162162;
-    fragColor = vec4(c, 1.0);
+    if (texelFetch(dofTiles, ivec2(gl_FragCoord.xy * tileScale), 0).r < 0.25) {
+        fragColor = texture(image, uv);
+        return;
+    }
+    vec4 center = texture(image, uv);
+    float wc = weights[0] * (center.a + 1e-3);
+    vec3 c = center.rgb * wc;
+    float total = wc;
+    for (int i = 1; i < 5; i++) {
+        vec4 a = texture(image, uv + texelDir * float(i));
+        vec4 b = texture(image, uv - texelDir * float(i));
+        float wa = weights[i] * (a.a + 1e-3);
+        float wb = weights[i] * (b.a + 1e-3);
+        c += a.rgb * wa + b.rgb * wb;
+        total += wa + wb;
+    }
+    fragColor = vec4(c / total, center.a);
 }
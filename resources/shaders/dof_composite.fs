@@ -1,29 +1,67 @@
 #version 330 core
+// props_merge.glsl is spliced in at load
 in vec2 fragTexCoord;
 out vec4 fragColor;
-uniform sampler2D sharpTex;
-uniform sampler2D blurTex;
-uniform sampler2D depthScene;
-uniform sampler2D depthProps;
-uniform sampler2D propsColorTex;
+uniform sampler2D texture0;   // Sharp frame (the drawn texture): the composite target, or fullResTarget when fused
+uniform float fusedComposite; // 1 = merge the props here instead of reading the composite target
+uniform sampler2D blurTex; // Last DOF chain level: blurred colour, alpha = blur amount of its footprint
 uniform mat4 invViewProj; // inverse(view * proj), same basis as raylib Vector3Unproject
 uniform vec3 camPos;
 uniform float dofSharpRadiusM; // no blur within this world distance from camera
 uniform float dofBlurFullDistM;
+uniform vec2 propsUvScale; // Props fill the bottom-left corner of their target (dynamic resolution)
+uniform vec2 propsUvMax;   // Half a texel inside that corner
+uniform float coverageInSharpAlpha; // 1 = props_upsample.fs stored the occlusion-aware props coverage in sharp.a
+uniform sampler2D dofTiles; // dof_tiles.fs classes (sharp 0, transition 0.5, blurred 1)
+uniform float tileScale;    // Tiles per full-res texel
+
+// Bilinear upsample of the low-res blur that favours taps whose blur amount matches this pixel's, so
+// blurred background doesn't pick up colour from across a depth edge
+vec3 UpsampleBlur(vec2 uv, float blurAmt)
+{
+    vec2 size = vec2(textureSize(blurTex, 0));
+    vec2 p = uv * size - 0.5;
+    vec2 base = floor(p);
+    vec2 f = p - base;
+    ivec2 maxTexel = ivec2(size) - 1;
+    vec3 sum = vec3(0.0);
+    float total = 0.0;
+    for (int i = 0; i < 4; i++) {
+        ivec2 offset = ivec2(i & 1, i >> 1);
+        vec4 tap = texelFetch(blurTex, clamp(ivec2(base) + offset, ivec2(0), maxTexel), 0);
+        vec2 bw = mix(1.0 - f, f, vec2(offset));
+        float w = bw.x * bw.y / (0.02 + abs(tap.a - blurAmt));
+        sum += tap.rgb * w;
+        total += w;
+    }
+    return sum / max(total, 1e-5);
+}
 
 void main()
 {
     vec2 uv = fragTexCoord;
-    vec4 sharp = texture(sharpTex, uv);
-    vec4 blurCol = texture(blurTex, uv);
-    float ds = texture(depthScene, uv).r;
-    float dp = texture(depthProps, uv).r;
-    vec4 pc = texture(propsColorTex, uv);
-    float d = mix(ds, dp, pc.a);
+    ivec2 t = min(ivec2(uv * vec2(textureSize(texture0, 0))), textureSize(texture0, 0) - 1);
+    float tileClass = texelFetch(dofTiles, ivec2(vec2(t) * tileScale), 0).r;
+    if (tileClass > 0.75) {
+        fragColor = vec4(UpsampleBlur(uv, 1.0), 1.0);
+        return;
+    }
+    vec4 sharp = texelFetch(texture0, t, 0);
+    if (fusedComposite > 0.5) sharp = MergeProps(t, sharp.rgb);
+    if (tileClass < 0.25) {
+        fragColor = vec4(sharp.rgb, 1.0);
+        return;
+    }
+    vec2 propsUv = min(uv * propsUvScale, propsUvMax);
+    float coverage = (fusedComposite > 0.5) ? sharp.a : mix(texture(propsColor, propsUv).a, sharp.a, coverageInSharpAlpha);
+    float ds = texelFetch(sceneDepth, t, 0).r;
+    float dp = texture(propsDepth, propsUv).r;
+    float d = mix(ds, dp, coverage);
     vec2 ndc = vec2(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0);
     vec4 w = invViewProj * vec4(ndc.x, ndc.y, d, 1.0);
     vec3 worldPos = w.xyz / w.w;
     float dist = length(worldPos - camPos);
     float blurAmt = smoothstep(dofSharpRadiusM, dofBlurFullDistM, dist);
-    fragColor = vec4(mix(sharp.rgb, blurCol.rgb, blurAmt), sharp.a);
+    vec3 blurred = (blurAmt > 0.0) ? UpsampleBlur(uv, blurAmt) : sharp.rgb;
+    fragColor = vec4(mix(sharp.rgb, blurred, blurAmt), 1.0);
 }
@@ -0,0 +1,57 @@
+#version 330 core
+// First level of the DOF chain: averages each 2x2 block of the sharp frame and stores its blur amount in
+// alpha, so the blur and the upsample in dof_composite.fs can tell sharp pixels from blurred ones.
+// Depth to blur amount matches dof_composite.fs. Sharp tiles only copy one unmerged texel at blur amount 0
+// (the upsample next to them may still read it) and fully blurred tiles skip the depth work.
+// props_merge.glsl is spliced in at load.
+out vec4 fragColor;
+uniform sampler2D texture0;   // Sharp frame (the drawn texture): the composite target, or fullResTarget when fused
+uniform float fusedComposite; // 1 = merge the props here instead of reading the composite target
+uniform mat4 invViewProj;
+uniform vec3 camPos;
+uniform float dofSharpRadiusM;
+uniform float dofBlurFullDistM;
+uniform vec2 propsUvScale;
+uniform vec2 propsUvMax;
+uniform float coverageInSharpAlpha;
+uniform sampler2D dofTiles;   // dof_tiles.fs classes (sharp 0, transition 0.5, blurred 1)
+uniform float tileScale;      // Tiles per full-res texel
+
+// Sharp colour at full-res texel t; alpha = props coverage
+vec4 SharpAt(ivec2 t, vec2 uv)
+{
+    vec4 sharp = texelFetch(texture0, t, 0);
+    if (fusedComposite > 0.5) return MergeProps(t, sharp.rgb);
+    float propsAlpha = texture(propsColor, min(uv * propsUvScale, propsUvMax)).a;
+    return vec4(sharp.rgb, mix(propsAlpha, sharp.a, coverageInSharpAlpha));
+}
+
+float BlurAmount(ivec2 t, vec2 uv, float coverage)
+{
+    float ds = texelFetch(sceneDepth, t, 0).r;
+    float d = mix(ds, texture(propsDepth, min(uv * propsUvScale, propsUvMax)).r, coverage);
+    vec2 ndc = vec2(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0);
+    vec4 w = invViewProj * vec4(ndc.x, ndc.y, d, 1.0);
+    float dist = length(w.xyz / w.w - camPos);
+    return smoothstep(dofSharpRadiusM, dofBlurFullDistM, dist);
+}
+
+void main()
+{
+    vec2 fullSize = vec2(textureSize(texture0, 0));
+    ivec2 base = ivec2(gl_FragCoord.xy) * 2;
+    float tileClass = texelFetch(dofTiles, ivec2(vec2(base) * tileScale), 0).r;
+    if (tileClass < 0.25) {
+        fragColor = vec4(texelFetch(texture0, base, 0).rgb, 0.0);
+        return;
+    }
+    ivec2 maxTexel = ivec2(fullSize) - 1;
+    vec4 sum = vec4(0.0);
+    for (int i = 0; i < 4; i++) {
+        ivec2 t = min(base + ivec2(i & 1, i >> 1), maxTexel);
+        vec2 uv = (vec2(t) + 0.5) / fullSize;
+        vec4 sharp = SharpAt(t, uv);
+        sum += vec4(sharp.rgb, (tileClass > 0.75) ? 1.0 : BlurAmount(t, uv, sharp.a));
+    }
+    fragColor = sum * 0.25;
+}
@@ -0,0 +1,50 @@
+#version 330 core
+// One fragment per DOF_TILE_SIZE screen tile: bounds the camera distance of everything in the tile from
+// its nearest and farthest view depth and writes DofTileClass / 2 (sharp, transition, blurred).
+// props_merge.glsl is spliced in at load for the depth inputs.
+out vec4 fragColor;
+uniform int tileSize;
+uniform vec2 tanHalfFov;       // Horizontal and vertical tan(fov / 2)
+uniform float dofSharpRadiusM;
+uniform float dofBlurFullDistM;
+uniform float classifyTiles;   // 0 = every tile is a transition tile (no perspective depth bounds)
+
+void main()
+{
+    if (classifyTiles < 0.5) {
+        fragColor = vec4(0.5, 0.0, 0.0, 1.0);
+        return;
+    }
+    ivec2 fullSize = textureSize(sceneDepth, 0);
+    ivec2 t0 = ivec2(gl_FragCoord.xy) * tileSize;
+    ivec2 t1 = min(t0 + tileSize, fullSize); // Exclusive
+
+    // Props sit in front of the scene wherever they cover it, so only they can lower the minimum
+    float minZ = farPlane;
+    float maxZ = 0.0;
+    for (int y = t0.y; y < t1.y; y++) {
+        for (int x = t0.x; x < t1.x; x++) {
+            float z = LinearDepth(texelFetch(sceneDepth, ivec2(x, y), 0).r);
+            minZ = min(minZ, z);
+            maxZ = max(maxZ, z);
+        }
+    }
+    vec2 propsScale = propsSize / vec2(fullSize);
+    ivec2 p0 = ivec2(floor(vec2(t0) * propsScale));
+    ivec2 p1 = min(ivec2(ceil(vec2(t1) * propsScale)), ivec2(propsSize));
+    for (int y = p0.y; y < p1.y; y++) {
+        for (int x = p0.x; x < p1.x; x++) {
+            minZ = min(minZ, LinearDepth(texelFetch(propsDepth, ivec2(x, y), 0).r));
+        }
+    }
+
+    // Distance is at least the view depth and at most view depth times the longest ray through the tile
+    vec2 ndc0 = abs(vec2(t0) / vec2(fullSize) * 2.0 - 1.0);
+    vec2 ndc1 = abs(vec2(t1) / vec2(fullSize) * 2.0 - 1.0);
+    vec2 edge = max(ndc0, ndc1) * tanHalfFov;
+    float maxDist = maxZ * sqrt(1.0 + dot(edge, edge));
+    float tileClass = 0.5;
+    if (maxDist <= dofSharpRadiusM) tileClass = 0.0;
+    else if (minZ >= dofBlurFullDistM) tileClass = 1.0;
+    fragColor = vec4(tileClass, 0.0, 0.0, 1.0);
+}
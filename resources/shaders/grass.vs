@@ -0,0 +1,44 @@
+#version 330 core
+// Instanced grass blades. Per-blade constants are packed per tile by CommitPropTile;
+// the lean animation runs here from the time uniform instead of on the CPU.
+
+in vec3 vertexPosition; // Quad corner in blade space (already scaled to billboardSize)
+in vec2 vertexTexCoord;
+layout(location = 10) in float instanceIndex; // PROPS_INSTANCE_ATTRIB_LOCATION
+
+uniform mat4 mvp;           // view * projection
+uniform float time;
+uniform sampler2D instanceData; // RGBA32F, 3 texels per prop: (pos.xyz, yaw), (pitch, speed, phase, maxLean), ground AO
+uniform int instanceDataWidth;
+
+out vec2 fragTexCoord;
+
+vec4 FetchInstanceTexel(int texel)
+{
+    return texelFetch(instanceData, ivec2(texel % instanceDataWidth, texel / instanceDataWidth), 0);
+}
+
+vec3 RotateX(vec3 v, float a) { float c = cos(a), s = sin(a); return vec3(v.x, c*v.y - s*v.z, s*v.y + c*v.z); }
+vec3 RotateY(vec3 v, float a) { float c = cos(a), s = sin(a); return vec3(c*v.x + s*v.z, v.y, -s*v.x + c*v.z); }
+vec3 RotateZ(vec3 v, float a) { float c = cos(a), s = sin(a); return vec3(c*v.x - s*v.y, s*v.x + c*v.y, v.z); }
+
+void main()
+{
+    int base = int(instanceIndex + 0.5) * 3; // PROP_INSTANCE_TEXELS
+    vec4 posYaw = FetchInstanceTexel(base);
+    vec4 blade = FetchInstanceTexel(base + 1);
+    float speed = blade.y;
+    float phase = blade.z;
+    float maxLean = blade.w;
+
+    float leanX = sin(time * speed + phase) * maxLean;
+    float leanZ = cos(time * (speed * 0.73) + phase * 1.37) * maxLean * 0.48;
+
+    // Lean (Z then X), then field pitch, then yaw: same order as the old CPU matrices
+    vec3 v = RotateZ(vertexPosition, leanZ);
+    v = RotateX(v, blade.x + leanX);
+    v = RotateY(v, posYaw.w);
+
+    fragTexCoord = vertexTexCoord;
+    gl_Position = mvp * vec4(posYaw.xyz + v, 1.0);
+}
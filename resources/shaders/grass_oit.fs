@@ -0,0 +1,24 @@
+#version 330 core
+// Weighted blended OIT (McGuire & Bavoil 2013) for grass: no sort needed.
+// Both targets are cleared to 0 and blended ONE, ONE; the resolve turns the second one into revealage.
+
+in vec2 fragTexCoord;
+
+uniform sampler2D texture0;
+
+layout(location = 0) out vec4 accum;     // RGBA16F: sum of weighted premultiplied color, weighted alpha
+layout(location = 1) out vec4 logReveal; // R16F: sum of -log(1 - alpha), revealage = exp(-sum)
+
+void main()
+{
+    vec4 color = texture(texture0, fragTexCoord);
+    float a = min(color.a, 0.999);
+    if (a < 0.004) discard;
+
+    // Depth weight from view distance (gl_FragCoord.w = 1 / clip w), eq. 9 of the paper
+    float z = 1.0 / gl_FragCoord.w;
+    float w = a * clamp(10.0 / (1e-5 + pow(z / 5.0, 2.0) + pow(z / 200.0, 6.0)), 1e-2, 3e3);
+
+    accum = vec4(color.rgb * a, a) * w;
+    logReveal = vec4(-log(1.0 - a), 0.0, 0.0, 0.0);
+}
@@ -0,0 +1,16 @@
+#version 330 core
+// Resolves the grass OIT targets over the props already in quarterResTarget (same size, so texelFetch)
+
+uniform sampler2D texture0;     // Accumulation
+uniform sampler2D revealageTex; // Sum of -log(1 - alpha)
+
+out vec4 finalColor;
+
+void main()
+{
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    float revealage = exp(-texelFetch(revealageTex, p, 0).r);
+    if (revealage > 0.999) discard;
+    vec4 accum = texelFetch(texture0, p, 0);
+    finalColor = vec4(accum.rgb / max(accum.a, 1e-5), 1.0 - revealage);
+}
@@ -0,0 +1,14 @@
+#version 330 core
+in vec2 decalCoord;
+in float strength;
+
+out vec4 finalColor;
+
+void main()
+{
+    // Radial falloff: full strength in the inner half, fading to zero at the rim
+    float d = length(decalCoord);
+    if (d >= 1.0) discard;
+    float falloff = 1.0 - smoothstep(0.55, 1.0, d);
+    finalColor = vec4(0.0, 0.0, 0.0, strength * falloff);
+}
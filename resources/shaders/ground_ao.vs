@@ -0,0 +1,29 @@
+#version 330 core
+// Instanced ground-contact AO decals: one flat quad under every visible prop.
+
+in vec3 vertexPosition; // Unit quad corner in XZ, [-1, 1]
+layout(location = 10) in float instanceIndex; // PROPS_INSTANCE_ATTRIB_LOCATION
+
+uniform mat4 mvp;           // view * projection
+uniform sampler2D instanceData; // RGBA32F, 3 texels per prop; texel 0 = pos.xyz, texel 2 = (radius, y offset, strength, 0)
+uniform int instanceDataWidth;
+
+out vec2 decalCoord;
+out float strength;
+
+vec4 FetchInstanceTexel(int texel)
+{
+    return texelFetch(instanceData, ivec2(texel % instanceDataWidth, texel / instanceDataWidth), 0);
+}
+
+void main()
+{
+    int base = int(instanceIndex + 0.5) * 3; // PROP_INSTANCE_TEXELS
+    vec3 position = FetchInstanceTexel(base).xyz;
+    vec4 ao = FetchInstanceTexel(base + 2);
+
+    decalCoord = vertexPosition.xz;
+    strength = ao.z;
+    vec3 world = position + vec3(vertexPosition.x * ao.x, ao.y, vertexPosition.z * ao.x);
+    gl_Position = mvp * vec4(world, 1.0);
+}
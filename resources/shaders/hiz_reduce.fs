@@ -0,0 +1,19 @@
+#version 330 core
+// One Hi-Z step: each texel keeps the farthest depth of its 2x2 source footprint.
+// Odd source sizes round the target up; the clamp folds the missing row/column onto the edge.
+
+uniform sampler2D sourceTex;
+uniform ivec2 sourceSize;
+
+out vec4 finalColor;
+
+void main()
+{
+    ivec2 p = ivec2(gl_FragCoord.xy) * 2;
+    ivec2 edge = sourceSize - 1;
+    float d0 = texelFetch(sourceTex, min(p, edge), 0).r;
+    float d1 = texelFetch(sourceTex, min(p + ivec2(1, 0), edge), 0).r;
+    float d2 = texelFetch(sourceTex, min(p + ivec2(0, 1), edge), 0).r;
+    float d3 = texelFetch(sourceTex, min(p + ivec2(1, 1), edge), 0).r;
+    finalColor = vec4(max(max(d0, d1), max(d2, d3)));
+}
@@ -0,0 +1,54 @@
+#version 330 core
+// Impostor shading matches lighting.fs, using the baked albedo and model-space normal atlases
+
+in vec2 atlasUV;
+in vec3 fragPos;
+in vec2 yawCosSin;
+in float lodFade;
+
+uniform vec3 lightPos;
+uniform vec3 lightColor;
+uniform vec3 viewPos;
+uniform sampler2D texture0; // Albedo atlas (alpha = coverage)
+uniform sampler2D texture1; // Normal atlas
+
+const float ambientStrength = 0.2;
+const float diffuseStrength = 1.0;
+const float specularStrength = 0.01;
+const float shininess = 16.0;
+
+out vec4 fragColor;
+
+float BayerDither(vec2 p)
+{
+    const float m[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0,
+                                  3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    ivec2 i = ivec2(mod(p, 4.0));
+    return (m[i.x + i.y * 4] + 0.5) / 16.0;
+}
+
+void main()
+{
+    // Complement of the mesh's discard in lighting.fs, so the crossfade band never doubles up
+    if (BayerDither(gl_FragCoord.xy) >= lodFade) discard;
+    vec4 texColor = texture(texture0, atlasUV);
+    if (texColor.a < 0.5) discard;
+
+    vec3 n = texture(texture1, atlasUV).xyz * 2.0 - 1.0;
+    vec2 cs = yawCosSin;
+    vec3 N = normalize(vec3(cs.x * n.x + cs.y * n.z, n.y, -cs.y * n.x + cs.x * n.z));
+
+    vec3 ambient = ambientStrength * lightColor;
+
+    vec3 lightDir = normalize(lightPos - fragPos);
+    float diff = max(dot(N, lightDir), 0.0);
+    vec3 diffuse = diffuseStrength * diff * lightColor;
+
+    vec3 viewDir = normalize(viewPos - fragPos);
+    vec3 reflectDir = reflect(-lightDir, N);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+    vec3 specular = specularStrength * spec * lightColor;
+
+    vec3 result = (ambient + diffuse + specular) * texColor.rgb;
+    fragColor = vec4(result, 1.0);
+}
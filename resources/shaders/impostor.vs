@@ -0,0 +1,70 @@
+#version 330 core
+// Octahedral impostor cards for distant rocks. Each instance picks the baked hemi-octahedral
+// view closest to its rock-local eye direction and orients the card to match that view.
+
+in vec3 vertexPosition; // Card corner in [-1, 1]^2 (xy)
+layout(location = 10) in float instanceIndex; // PROPS_INSTANCE_ATTRIB_LOCATION
+
+uniform mat4 mvp;           // view * projection
+uniform sampler2D instanceData; // RGBA32F, 3 texels per prop: (pos.xyz, scale), (cos yaw, sin yaw, 0, 0), ground AO
+uniform int instanceDataWidth;
+uniform vec3 viewPos;
+uniform vec2 impostorFade;    // Crossfade band (start, end) in meters from the camera
+uniform vec4 impostorBounds;  // Model-space bounding sphere: center.xyz, radius
+uniform int impostorFrames;   // Views per atlas side
+
+out vec2 atlasUV;
+out vec3 fragPos;
+out vec2 yawCosSin;
+out float lodFade;
+
+vec4 FetchInstanceTexel(int texel)
+{
+    return texelFetch(instanceData, ivec2(texel % instanceDataWidth, texel / instanceDataWidth), 0);
+}
+
+// Must match the C side in props.c (HemiOctDecode / GetImpostorFrameBasis)
+vec2 HemiOctEncode(vec3 d)
+{
+    d.y = max(d.y, 0.0);
+    vec2 p = d.xz / (abs(d.x) + d.y + abs(d.z));
+    return vec2(p.x + p.y, p.x - p.y);
+}
+
+vec3 HemiOctDecode(vec2 o)
+{
+    float x = (o.x + o.y) * 0.5;
+    float z = (o.x - o.y) * 0.5;
+    return normalize(vec3(x, 1.0 - abs(x) - abs(z), z));
+}
+
+void main()
+{
+    int base = int(instanceIndex + 0.5) * 3; // PROP_INSTANCE_TEXELS
+    vec4 posScale = FetchInstanceTexel(base);
+    vec2 cs = FetchInstanceTexel(base + 1).xy;
+    float scale = posScale.w;
+
+    // Rock yaw (MatrixRotateY) and its inverse
+    vec3 c = impostorBounds.xyz * scale;
+    vec3 center = posScale.xyz + vec3(cs.x * c.x + cs.y * c.z, c.y, -cs.y * c.x + cs.x * c.z);
+    vec3 toEye = viewPos - center;
+    vec3 localEye = vec3(cs.x * toEye.x - cs.y * toEye.z, toEye.y, cs.y * toEye.x + cs.x * toEye.z);
+
+    float frames = float(impostorFrames);
+    vec2 oct = HemiOctEncode(normalize(localEye + vec3(0.0, 1e-4, 0.0)));
+    vec2 frame = clamp(floor((oct * 0.5 + 0.5) * frames), 0.0, frames - 1.0);
+    vec3 frameDir = HemiOctDecode((frame + 0.5) / frames * 2.0 - 1.0);
+    vec3 upHint = abs(frameDir.y) > 0.999 ? vec3(0.0, 0.0, -1.0) : vec3(0.0, 1.0, 0.0);
+    vec3 right = normalize(cross(upHint, frameDir));
+    vec3 up = cross(frameDir, right);
+
+    vec3 offset = (right * vertexPosition.x + up * vertexPosition.y) * impostorBounds.w * scale;
+    fragPos = center + vec3(cs.x * offset.x + cs.y * offset.z, offset.y, -cs.y * offset.x + cs.x * offset.z);
+    atlasUV = (frame + vertexPosition.xy * 0.5 + 0.5) / frames;
+    yawCosSin = cs;
+
+    float dist = distance(posScale.xyz, viewPos);
+    lodFade = clamp((dist - impostorFade.x) / max(impostorFade.y - impostorFade.x, 1e-4), 0.0, 1.0);
+    gl_Position = mvp * vec4(fragPos, 1.0);
+}
@@ -0,0 +1,34 @@
+#version 330 core
+// bakeNormals = 0: albedo; 1: model-space normal (with the tangent-space map applied) as xyz * 0.5 + 0.5
+
+in vec3 normal;
+in vec2 texCoord;
+in vec3 modelTangent;
+in float tangentSign;
+
+uniform vec2 uvScale;
+uniform float useNormalMap;
+uniform int bakeNormals;
+uniform sampler2D texture0;
+uniform sampler2D texture1;
+
+out vec4 fragColor;
+
+void main()
+{
+    vec2 tiledUV = texCoord * uvScale;
+    if (bakeNormals == 0) {
+        fragColor = vec4(texture(texture0, tiledUV).rgb, 1.0);
+        return;
+    }
+
+    vec3 Ngeom = normalize(normal);
+    vec3 N = Ngeom;
+    if (useNormalMap > 0.5) {
+        vec3 T = normalize(modelTangent - dot(modelTangent, Ngeom) * Ngeom);
+        vec3 B = normalize(cross(Ngeom, T) * tangentSign);
+        vec3 mapN = texture(texture1, tiledUV).rgb * 2.0 - 1.0;
+        N = normalize(mat3(T, B, Ngeom) * mapN);
+    }
+    fragColor = vec4(N * 0.5 + 0.5, 1.0);
+}
@@ -0,0 +1,24 @@
+#version 330 core
+// Bakes rock views into the impostor atlas (model space: the rock is drawn untransformed)
+
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+in vec2 vertexTexCoord;
+in vec4 vertexTangent;
+
+uniform mat4 mvp;
+uniform mat4 matNormal;
+
+out vec3 normal;
+out vec2 texCoord;
+out vec3 modelTangent;
+out float tangentSign;
+
+void main()
+{
+    normal = mat3(matNormal) * vertexNormal;
+    modelTangent = mat3(matNormal) * vertexTangent.xyz;
+    tangentSign = vertexTangent.w;
+    texCoord = vertexTexCoord;
+    gl_Position = mvp * vec4(vertexPosition, 1.0);
+}
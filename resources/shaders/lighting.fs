@@ -6,6 +6,7 @@ in vec3 normal;
 in vec2 texCoord;
 in vec3 worldTangent;
 in float tangentSign;
+in float lodFade; // Instanced rocks: dithered handover to the impostor (0 = keep every pixel)
 
 uniform vec3 lightPos;
 uniform vec3 lightColor;
@@ -23,8 +24,18 @@ const float shininess = 16.0;
 
 out vec4 fragColor;
 
+float BayerDither(vec2 p)
+{
+    const float m[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0,
+                                  3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    ivec2 i = ivec2(mod(p, 4.0));
+    return (m[i.x + i.y * 4] + 0.5) / 16.0;
+}
+
 void main()
 {
+    if (lodFade > 0.0 && BayerDither(gl_FragCoord.xy) < lodFade) discard;
+
     vec2 tiledUV = texCoord * uvScale;
     vec4 texColor = texture(texture0, tiledUV);
 
@@ -15,6 +15,7 @@ out vec3 normal;
 out vec2 texCoord;
 out vec3 worldTangent;
 out float tangentSign;
+out float lodFade; // Only instanced rocks crossfade to impostors
 
 void main()
 {
@@ -23,5 +24,6 @@ void main()
     worldTangent = mat3(matNormal) * vertexTangent.xyz;
     tangentSign = vertexTangent.w;
     texCoord = vertexTexCoord;
+    lodFade = 0.0;
     gl_Position = mvp * vec4(vertexPosition, 1.0);
 }
@@ -0,0 +1,52 @@
+#version 330 core
+// Instanced variant of lighting.vs: one draw per mesh covers every visible rock.
+// Per-instance transforms live in a float texture packed per tile by CommitPropTile;
+// the only per-frame data is the prop index of each visible instance.
+
+in vec3 vertexPosition;
+in vec3 vertexNormal;
+in vec2 vertexTexCoord;
+in vec4 vertexTangent; // xyz = tangent, w = handedness for bitangent (MikkTSpace / raylib)
+layout(location = 10) in float instanceIndex; // PROPS_INSTANCE_ATTRIB_LOCATION
+
+uniform mat4 mvp;           // view * projection only; the model matrix is built per instance
+uniform mat4 meshTransform; // Model.transform, applied before the instance transform
+uniform sampler2D instanceData; // RGBA32F, 3 texels per prop: (pos.xyz, scale), (cos yaw, sin yaw, 0, 0), ground AO
+uniform int instanceDataWidth;
+uniform vec3 viewPos;
+uniform vec2 impostorFade; // Impostor crossfade band (start, end) in meters from the camera
+
+out vec3 fragPos;
+out vec3 normal;
+out vec2 texCoord;
+out vec3 worldTangent;
+out float tangentSign;
+out float lodFade; // 0 = mesh, 1 = fully handed over to the impostor
+
+vec4 FetchInstanceTexel(int texel)
+{
+    return texelFetch(instanceData, ivec2(texel % instanceDataWidth, texel / instanceDataWidth), 0);
+}
+
+void main()
+{
+    int base = int(instanceIndex + 0.5) * 3; // PROP_INSTANCE_TEXELS
+    vec4 posScale = FetchInstanceTexel(base);
+    vec4 yaw = FetchInstanceTexel(base + 1);
+
+    // Same Y rotation as MatrixRotateY / DrawModelEx (uniform scale, so it doubles as the normal matrix)
+    mat3 rotation = mat3(yaw.x, 0.0, -yaw.y,
+                         0.0,   1.0,  0.0,
+                         yaw.y, 0.0,  yaw.x);
+    mat3 meshRotation = mat3(meshTransform);
+
+    vec3 local = vec3(meshTransform * vec4(vertexPosition, 1.0));
+    fragPos = rotation * (local * posScale.w) + posScale.xyz;
+    normal = rotation * (meshRotation * vertexNormal);
+    worldTangent = rotation * (meshRotation * vertexTangent.xyz);
+    tangentSign = vertexTangent.w;
+    texCoord = vertexTexCoord;
+    float dist = distance(posScale.xyz, viewPos);
+    lodFade = clamp((dist - impostorFade.x) / max(impostorFade.y - impostorFade.x, 1e-4), 0.0, 1.0);
+    gl_Position = mvp * vec4(fragPos, 1.0);
+}
@@ -0,0 +1,58 @@
+// Props-over-scene merge, spliced after the #version line of props_upsample.fs and the DOF shaders by
+// LoadShaderWithPropsMerge. Joint bilateral upsample guided by the full-res scene depth: each of the four
+// nearest props texels keeps its bilinear weight only where the scene surface at the pixel is not in front
+// of it, so grass doesn't bleed across terrain silhouettes. Colour is further weighted towards the
+// nearest surviving prop depth.
+
+uniform sampler2D sceneDepth; // fullResTarget depth
+uniform sampler2D propsColor; // quarterResTarget
+uniform sampler2D propsDepth;
+uniform vec2 propsSize;       // Props viewport in texels (bottom-left corner of the props target)
+uniform float nearPlane;
+uniform float farPlane;
+uniform float depthTolerance; // PROPS_UPSAMPLE_DEPTH_TOLERANCE: fraction of the distance a prop may sit behind the scene
+
+float LinearDepth(float d)
+{
+    return nearPlane * farPlane / (farPlane - d * (farPlane - nearPlane));
+}
+
+// Scene colour at full-res texel t with the props merged over it; alpha = props coverage
+vec4 MergeProps(ivec2 t, vec3 scene)
+{
+    vec2 fullSize = vec2(textureSize(sceneDepth, 0));
+    float sceneZ = LinearDepth(texelFetch(sceneDepth, t, 0).r);
+
+    vec2 p = (vec2(t) + 0.5) * (propsSize / fullSize) - 0.5;
+    vec2 base = floor(p);
+    vec2 f = p - base;
+    ivec2 maxTexel = ivec2(propsSize) - 1;
+
+    vec4 taps[4];
+    float tapZ[4];
+    float weight[4];
+    float nearestZ = farPlane;
+    for (int i = 0; i < 4; i++) {
+        ivec2 offset = ivec2(i & 1, i >> 1);
+        ivec2 pt = clamp(ivec2(base) + offset, ivec2(0), maxTexel);
+        taps[i] = texelFetch(propsColor, pt, 0);
+        tapZ[i] = LinearDepth(texelFetch(propsDepth, pt, 0).r);
+        vec2 w = mix(1.0 - f, f, vec2(offset));
+        float behind = smoothstep(0.0, depthTolerance, (tapZ[i] - sceneZ) / sceneZ);
+        weight[i] = w.x * w.y * (1.0 - behind) * taps[i].a;
+        if (weight[i] > 0.0) nearestZ = min(nearestZ, tapZ[i]);
+    }
+
+    // Bilinear weights sum to one, so dropped taps thin the coverage instead of stretching neighbours
+    float coverage = 0.0;
+    vec3 color = vec3(0.0);
+    float colorWeight = 0.0;
+    for (int i = 0; i < 4; i++) {
+        coverage += weight[i];
+        float similar = weight[i] / (1.0 + abs(tapZ[i] - nearestZ) / (nearestZ * depthTolerance));
+        color += taps[i].rgb * similar;
+        colorWeight += similar;
+    }
+    color = (colorWeight > 0.0) ? color / colorWeight : scene;
+    return vec4(mix(scene, color, coverage), coverage);
+}
@@ -0,0 +1,15 @@
+#version 330 core
+// Merges the low-res props layer over the full-res scene into the composite target (MergeProps in
+// props_merge.glsl, spliced in at load). Output alpha is the props coverage; the DOF passes use it to
+// pick the depth.
+
+in vec2 fragTexCoord;
+
+uniform sampler2D texture0; // Scene colour (fullResTarget)
+
+out vec4 finalColor;
+
+void main()
+{
+    finalColor = MergeProps(ivec2(gl_FragCoord.xy), texture(texture0, fragTexCoord).rgb);
+}
@@ -0,0 +1,68 @@
+#version 330 core
+// CDLOD terrain node: the shared grid patch is placed per instance inside its streamed tile, displaced
+// from the tile's square of the height atlas, and its odd vertices morph onto the next coarser grid as
+// they near the end of the level's range. Outputs match lighting.vs so the scene keeps using lighting.fs.
+
+in vec2 vertexPosition; // Patch grid coordinate, 0..TERRAIN_PATCH_QUADS
+layout(location = 10) in vec4 instanceNode; // TERRAIN_NODE_ATTRIB_LOCATION: origin x, origin z (tile samples), spacing (samples), level
+layout(location = 11) in vec4 instanceTile; // World x, world z of the tile, atlas texel x, y of its square
+
+uniform mat4 mvp;            // view * projection; positions are already in world space
+uniform sampler2D heightMap; // R32F atlas, one texel per heightfield vertex
+uniform sampler2D normalMap; // RGBA8 atlas of generator normals, same layout
+uniform int tileSamples;     // Samples per tile edge, shared edges included
+uniform float terrainCellSize;
+uniform vec2 morphRange[12]; // TERRAIN_LOD_MAX_LEVELS: (start, end) camera distance per level
+uniform vec3 viewPos;
+
+const float uvRepeat = 180.0; // TERRAIN_UV_REPEAT per 500 m
+
+out vec3 fragPos;
+out vec3 normal;
+out vec2 texCoord;
+out vec3 worldTangent;
+out float tangentSign;
+out float lodFade; // Terrain never dithers
+
+// Bilinear atlas lookup at a position in tile samples (morphing vertices land between samples).
+// Clamped to the tile so neighbouring squares never bleed in.
+vec4 SampleTile(sampler2D atlas, vec2 p)
+{
+    p = clamp(p, vec2(0.0), vec2(float(tileSamples - 1)));
+    vec2 base = min(floor(p), vec2(float(tileSamples - 2)));
+    vec2 f = p - base;
+    ivec2 i = ivec2(base) + ivec2(instanceTile.zw);
+    vec4 s00 = texelFetch(atlas, i, 0);
+    vec4 s10 = texelFetch(atlas, i + ivec2(1, 0), 0);
+    vec4 s01 = texelFetch(atlas, i + ivec2(0, 1), 0);
+    vec4 s11 = texelFetch(atlas, i + ivec2(1, 1), 0);
+    return mix(mix(s00, s10, f.x), mix(s01, s11, f.x), f.y);
+}
+
+void main()
+{
+    vec2 origin = instanceNode.xy;
+    float spacing = instanceNode.z;
+    int level = int(instanceNode.w + 0.5);
+
+    // Morph factor from the unmorphed vertex, so both sides of a node edge agree on it
+    vec2 samplePos = origin + vertexPosition * spacing;
+    vec3 unmorphed = vec3(instanceTile.x + samplePos.x * terrainCellSize, SampleTile(heightMap, samplePos).r,
+                          instanceTile.y + samplePos.y * terrainCellSize);
+    vec2 range = morphRange[level];
+    float morph = clamp((distance(unmorphed, viewPos) - range.x) / max(range.y - range.x, 1e-4), 0.0, 1.0);
+
+    // Odd grid vertices slide onto their even neighbour; at morph = 1 the patch is the next level's grid
+    vec2 grid = vertexPosition - fract(vertexPosition * 0.5) * 2.0 * morph;
+    samplePos = origin + grid * spacing;
+    fragPos = vec3(instanceTile.x + samplePos.x * terrainCellSize, SampleTile(heightMap, samplePos).r,
+                   instanceTile.y + samplePos.y * terrainCellSize);
+
+    // Normals come from the generator, which sees across tile edges
+    normal = normalize(SampleTile(normalMap, samplePos).xyz * 2.0 - 1.0);
+    worldTangent = normalize(vec3(normal.y, -normal.x, 0.0)); // +X along the surface
+    tangentSign = -1.0; // u runs along +X and v along +Z, as GenMeshTangents gave the old grid mesh
+    texCoord = fragPos.xz * (uvRepeat / 500.0);
+    lodFade = 0.0;
+    gl_Position = mvp * vec4(fragPos, 1.0);
+}
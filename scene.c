@@ -1,9 +1,14 @@
 #include "scene.h"
+#include "rlgl.h"
 #include <stdlib.h>
 #include <math.h>
 #include <limits.h>
 #include <string.h>
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 static float Hash2D(int x, int y, unsigned int seed) {
     unsigned int h = (unsigned int)(x * 374761393u + y * 668265263u) ^ (seed * 1442695041u);
     h = (h ^ (h >> 13)) * 1274126177u;
@@ -67,6 +72,177 @@ static float RidgeNoise2D(float x, float z, unsigned int seed, int octaves, floa
     return (norm > 0.0f) ? (sum / norm) : 0.0f;
 }
 
+// Lane-parallel copy of the terrain noise chain (Hash2D -> ValueNoise2D -> FBM2D/RidgeNoise2D -> height),
+// NOISE_LANES consecutive samples of a row at a time. Every lane performs the scalar code's float
+// operations in the same order, with exact emulations where the instruction set lacks one (floor on
+// SSE2, 32-bit multiply on SSE2, unsigned to float), so results are bit-identical to
+// GenerateTerrainHeight on x86-64. That holds as long as neither path is built with FMA contraction
+// (-std=c99 keeps it off); tiles depend on it so shared edges and GetTerrainHeightAt's fallback agree.
+#if defined(__AVX2__)
+#define NOISE_LANES 8
+typedef __m256 LaneFloat;
+typedef __m256i LaneInt;
+
+static inline LaneFloat LaneSet(float v) { return _mm256_set1_ps(v); }
+static inline LaneFloat LaneAdd(LaneFloat a, LaneFloat b) { return _mm256_add_ps(a, b); }
+static inline LaneFloat LaneSub(LaneFloat a, LaneFloat b) { return _mm256_sub_ps(a, b); }
+static inline LaneFloat LaneMul(LaneFloat a, LaneFloat b) { return _mm256_mul_ps(a, b); }
+static inline LaneFloat LaneDiv(LaneFloat a, LaneFloat b) { return _mm256_div_ps(a, b); }
+static inline LaneFloat LaneMin(LaneFloat a, LaneFloat b) { return _mm256_min_ps(a, b); }
+static inline LaneFloat LaneMax(LaneFloat a, LaneFloat b) { return _mm256_max_ps(a, b); }
+static inline LaneFloat LaneAbs(LaneFloat a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+static inline LaneFloat LaneFloor(LaneFloat a) { return _mm256_floor_ps(a); }
+static inline LaneInt LaneToInt(LaneFloat a) { return _mm256_cvttps_epi32(a); }
+static inline LaneFloat LaneFromInt(LaneInt a) { return _mm256_cvtepi32_ps(a); }
+static inline LaneFloat LaneSqrt(LaneFloat a) { return _mm256_sqrt_ps(a); }
+static inline LaneFloat LaneLoad(const float* in) { return _mm256_loadu_ps(in); }
+static inline void LaneStore(float* out, LaneFloat a) { _mm256_storeu_ps(out, a); }
+static inline LaneFloat LaneGather(const float* base, LaneInt index) { return _mm256_i32gather_ps(base, index, 4); }
+static inline LaneInt LaneIntLoad(const int* in) { return _mm256_loadu_si256((const __m256i*)in); }
+static inline void LaneIntStore(int* out, LaneInt a) { _mm256_storeu_si256((__m256i*)out, a); }
+static inline LaneInt LaneIntSet(unsigned int v) { return _mm256_set1_epi32((int)v); }
+static inline LaneInt LaneIntRamp(int first) { return _mm256_add_epi32(_mm256_set1_epi32(first), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)); }
+static inline LaneInt LaneIntAdd(LaneInt a, LaneInt b) { return _mm256_add_epi32(a, b); }
+static inline LaneInt LaneIntMul(LaneInt a, LaneInt b) { return _mm256_mullo_epi32(a, b); }
+static inline LaneInt LaneIntXor(LaneInt a, LaneInt b) { return _mm256_xor_si256(a, b); }
+#define LaneIntShiftRight(a, bits) _mm256_srli_epi32((a), (bits))
+
+// Unsigned 32-bit to float: both 16-bit halves convert exactly, so the one rounding is in the add
+static inline LaneFloat LaneFromUint(LaneInt a) {
+    LaneFloat hi = _mm256_cvtepi32_ps(_mm256_srli_epi32(a, 16));
+    LaneFloat lo = _mm256_cvtepi32_ps(_mm256_and_si256(a, _mm256_set1_epi32(0xffff)));
+    return _mm256_add_ps(_mm256_mul_ps(hi, _mm256_set1_ps(65536.0f)), lo);
+}
+#elif defined(__SSE2__)
+#define NOISE_LANES 4
+typedef __m128 LaneFloat;
+typedef __m128i LaneInt;
+
+static inline LaneFloat LaneSet(float v) { return _mm_set1_ps(v); }
+static inline LaneFloat LaneAdd(LaneFloat a, LaneFloat b) { return _mm_add_ps(a, b); }
+static inline LaneFloat LaneSub(LaneFloat a, LaneFloat b) { return _mm_sub_ps(a, b); }
+static inline LaneFloat LaneMul(LaneFloat a, LaneFloat b) { return _mm_mul_ps(a, b); }
+static inline LaneFloat LaneDiv(LaneFloat a, LaneFloat b) { return _mm_div_ps(a, b); }
+static inline LaneFloat LaneMin(LaneFloat a, LaneFloat b) { return _mm_min_ps(a, b); }
+static inline LaneFloat LaneMax(LaneFloat a, LaneFloat b) { return _mm_max_ps(a, b); }
+static inline LaneFloat LaneAbs(LaneFloat a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline LaneInt LaneToInt(LaneFloat a) { return _mm_cvttps_epi32(a); }
+static inline LaneFloat LaneFromInt(LaneInt a) { return _mm_cvtepi32_ps(a); }
+static inline LaneFloat LaneSqrt(LaneFloat a) { return _mm_sqrt_ps(a); }
+static inline LaneFloat LaneLoad(const float* in) { return _mm_loadu_ps(in); }
+static inline void LaneStore(float* out, LaneFloat a) { _mm_storeu_ps(out, a); }
+static inline LaneInt LaneIntLoad(const int* in) { return _mm_loadu_si128((const __m128i*)in); }
+static inline void LaneIntStore(int* out, LaneInt a) { _mm_storeu_si128((__m128i*)out, a); }
+
+// No gather before AVX2: four scalar loads
+static inline LaneFloat LaneGather(const float* base, LaneInt index) {
+    int i[4];
+    _mm_storeu_si128((__m128i*)i, index);
+    return _mm_setr_ps(base[i[0]], base[i[1]], base[i[2]], base[i[3]]);
+}
+static inline LaneInt LaneIntSet(unsigned int v) { return _mm_set1_epi32((int)v); }
+static inline LaneInt LaneIntRamp(int first) { return _mm_add_epi32(_mm_set1_epi32(first), _mm_setr_epi32(0, 1, 2, 3)); }
+static inline LaneInt LaneIntAdd(LaneInt a, LaneInt b) { return _mm_add_epi32(a, b); }
+static inline LaneInt LaneIntXor(LaneInt a, LaneInt b) { return _mm_xor_si128(a, b); }
+#define LaneIntShiftRight(a, bits) _mm_srli_epi32((a), (bits))
+
+// Truncate, then step down where that rounded up (negative non-integers); exact for |a| < 2^31
+static inline LaneFloat LaneFloor(LaneFloat a) {
+    LaneFloat t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+}
+
+// Low 32 bits of each product; SSE2 only multiplies the even lanes, so do odd lanes separately
+static inline LaneInt LaneIntMul(LaneInt a, LaneInt b) {
+    LaneInt even = _mm_mul_epu32(a, b);
+    LaneInt odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// Unsigned 32-bit to float: both 16-bit halves convert exactly, so the one rounding is in the add
+static inline LaneFloat LaneFromUint(LaneInt a) {
+    LaneFloat hi = _mm_cvtepi32_ps(_mm_srli_epi32(a, 16));
+    LaneFloat lo = _mm_cvtepi32_ps(_mm_and_si128(a, _mm_set1_epi32(0xffff)));
+    return _mm_add_ps(_mm_mul_ps(hi, _mm_set1_ps(65536.0f)), lo);
+}
+#endif
+
+#ifdef NOISE_LANES
+static LaneFloat Hash2DLanes(LaneInt x, LaneInt y, unsigned int seed) {
+    LaneInt h = LaneIntAdd(LaneIntMul(x, LaneIntSet(374761393u)), LaneIntMul(y, LaneIntSet(668265263u)));
+    h = LaneIntXor(h, LaneIntSet(seed * 1442695041u));
+    h = LaneIntMul(LaneIntXor(h, LaneIntShiftRight(h, 13)), LaneIntSet(1274126177u));
+    h = LaneIntXor(h, LaneIntShiftRight(h, 16));
+    return LaneDiv(LaneFromUint(h), LaneSet((float)UINT_MAX));
+}
+
+static LaneFloat SmoothstepLanes(LaneFloat t) {
+    return LaneMul(LaneMul(t, t), LaneSub(LaneSet(3.0f), LaneMul(LaneSet(2.0f), t)));
+}
+
+// raymath Lerp: a + t * (b - a)
+static LaneFloat LerpLanes(LaneFloat a, LaneFloat b, LaneFloat t) {
+    return LaneAdd(a, LaneMul(t, LaneSub(b, a)));
+}
+
+static LaneFloat ValueNoise2DLanes(LaneFloat x, LaneFloat z, unsigned int seed) {
+    LaneFloat fx0 = LaneFloor(x);
+    LaneFloat fz0 = LaneFloor(z);
+    LaneInt x0 = LaneToInt(fx0);
+    LaneInt z0 = LaneToInt(fz0);
+    LaneInt x1 = LaneIntAdd(x0, LaneIntSet(1));
+    LaneInt z1 = LaneIntAdd(z0, LaneIntSet(1));
+
+    LaneFloat sx = SmoothstepLanes(LaneSub(x, fx0));
+    LaneFloat sz = SmoothstepLanes(LaneSub(z, fz0));
+
+    LaneFloat nx0 = LerpLanes(Hash2DLanes(x0, z0, seed), Hash2DLanes(x1, z0, seed), sx);
+    LaneFloat nx1 = LerpLanes(Hash2DLanes(x0, z1, seed), Hash2DLanes(x1, z1, seed), sx);
+    return LaneSub(LaneMul(LerpLanes(nx0, nx1, sz), LaneSet(2.0f)), LaneSet(1.0f));
+}
+
+// Frequency, amplitude and norm are the same for every lane, so they stay scalar as in FBM2D
+static LaneFloat FBM2DLanes(LaneFloat x, LaneFloat z, unsigned int seed, int octaves, float lacunarity, float gain) {
+    float frequency = 1.0f;
+    float amplitude = 1.0f;
+    LaneFloat sum = LaneSet(0.0f);
+    float norm = 0.0f;
+    for (int i = 0; i < octaves; i++) {
+        LaneFloat f = LaneSet(frequency);
+        LaneFloat n = ValueNoise2DLanes(LaneMul(x, f), LaneMul(z, f), seed + (unsigned int)(i * 1987));
+        sum = LaneAdd(sum, LaneMul(n, LaneSet(amplitude)));
+        norm += amplitude;
+        frequency *= lacunarity;
+        amplitude *= gain;
+    }
+    return (norm > 0.0f) ? LaneDiv(sum, LaneSet(norm)) : LaneSet(0.0f);
+}
+
+static LaneFloat RidgeNoise2DLanes(LaneFloat x, LaneFloat z, unsigned int seed, int octaves, float lacunarity, float gain) {
+    float frequency = 1.0f;
+    float amplitude = 1.0f;
+    LaneFloat sum = LaneSet(0.0f);
+    float norm = 0.0f;
+    for (int i = 0; i < octaves; i++) {
+        LaneFloat f = LaneSet(frequency);
+        LaneFloat n = ValueNoise2DLanes(LaneMul(x, f), LaneMul(z, f), seed + (unsigned int)(i * 3571));
+        LaneFloat ridge = LaneSub(LaneSet(1.0f), LaneAbs(n));
+        ridge = LaneMul(ridge, ridge);
+        sum = LaneAdd(sum, LaneMul(ridge, LaneSet(amplitude)));
+        norm += amplitude;
+        frequency *= lacunarity;
+        amplitude *= gain;
+    }
+    return (norm > 0.0f) ? LaneDiv(sum, LaneSet(norm)) : LaneSet(0.0f);
+}
+
+// raymath Clamp to [0, 1]
+static LaneFloat Saturate(LaneFloat v) {
+    return LaneMin(LaneMax(v, LaneSet(0.0f)), LaneSet(1.0f));
+}
+#endif
+
 static bool BuildNormalMapPath(const char* diffusePath, char* outPath, size_t outPathSize) {
     const char* extension = strrchr(diffusePath, '.');
     if (extension != NULL && extension != diffusePath) {
@@ -76,16 +252,390 @@ static bool BuildNormalMapPath(const char* diffusePath, char* outPath, size_t ou
     return snprintf(outPath, outPathSize, "%s_n", diffusePath) > 0;
 }
 
-Scene InitScene(float width, float length, float height, float thickness, 
-                const char* wallTexturePath, const char* floorTexturePath, Shader lightingShader, unsigned int terrainSeed) {
+// World-space height of heightfield sample (sampleX, sampleZ); sample (0, 0) sits at the world origin
+static float GenerateTerrainHeight(const Scene* scene, int sampleX, int sampleZ) {
+    unsigned int terrainSeed = scene->terrainSeed;
+    float worldX = (float)sampleX * scene->terrainCellSize;
+    float worldZ = (float)sampleZ * scene->terrainCellSize;
+    float baseX = worldX * 0.012f;
+    float baseZ = worldZ * 0.012f;
+    float warpX = FBM2D(baseX + 37.1f, baseZ - 12.4f, terrainSeed + 911u, 3, 2.1f, 0.5f);
+    float warpZ = FBM2D(baseX - 18.6f, baseZ + 25.7f, terrainSeed + 1823u, 3, 2.1f, 0.5f);
+    float warpedX = baseX + warpX * 0.9f;
+    float warpedZ = baseZ + warpZ * 0.9f;
+    float macro = FBM2D(warpedX * 0.65f, warpedZ * 0.65f, terrainSeed, 5, 2.0f, 0.5f);
+    float detail = FBM2D(warpedX * 2.3f, warpedZ * 2.3f, terrainSeed + 457u, 4, 2.2f, 0.45f);
+    float ridges = RidgeNoise2D(warpedX * 1.45f, warpedZ * 1.45f, terrainSeed + 1291u, 4, 2.0f, 0.5f);
+    float peakMaskRaw = FBM2D(warpedX * 0.22f, warpedZ * 0.22f, terrainSeed + 2903u, 3, 2.0f, 0.55f);
+    float peakMask = Clamp((peakMaskRaw - 0.45f) / 0.55f, 0.0f, 1.0f);
+    peakMask = peakMask * peakMask;
+    float tallPeaks = RidgeNoise2D(warpedX * 0.85f, warpedZ * 0.85f, terrainSeed + 3761u, 4, 2.1f, 0.5f) * peakMask;
+    float heightShape = macro * 0.75f + detail * 0.30f + (ridges * 2.0f - 1.0f) * 0.65f + tallPeaks * 1.6f;
+    float heightValue = heightShape * (scene->terrainHeightScale * 1.55f);
+    float extremePeakMask = Clamp((peakMask - 0.90f) / 0.10f, 0.0f, 1.0f);
+    heightValue *= (1.0f + 0.70f * extremePeakMask);
+    return heightValue;
+}
+
+#ifdef NOISE_LANES
+// GenerateTerrainHeight for samples firstSampleX .. firstSampleX + NOISE_LANES - 1 of row sampleZ
+static void GenerateTerrainHeightLanes(const Scene* scene, int firstSampleX, int sampleZ, float* out) {
+    unsigned int terrainSeed = scene->terrainSeed;
+    LaneFloat worldX = LaneMul(LaneFromInt(LaneIntRamp(firstSampleX)), LaneSet(scene->terrainCellSize));
+    LaneFloat worldZ = LaneSet((float)sampleZ * scene->terrainCellSize);
+    LaneFloat baseX = LaneMul(worldX, LaneSet(0.012f));
+    LaneFloat baseZ = LaneMul(worldZ, LaneSet(0.012f));
+    LaneFloat warpX = FBM2DLanes(LaneAdd(baseX, LaneSet(37.1f)), LaneSub(baseZ, LaneSet(12.4f)), terrainSeed + 911u, 3, 2.1f, 0.5f);
+    LaneFloat warpZ = FBM2DLanes(LaneSub(baseX, LaneSet(18.6f)), LaneAdd(baseZ, LaneSet(25.7f)), terrainSeed + 1823u, 3, 2.1f, 0.5f);
+    LaneFloat warpedX = LaneAdd(baseX, LaneMul(warpX, LaneSet(0.9f)));
+    LaneFloat warpedZ = LaneAdd(baseZ, LaneMul(warpZ, LaneSet(0.9f)));
+    LaneFloat macro = FBM2DLanes(LaneMul(warpedX, LaneSet(0.65f)), LaneMul(warpedZ, LaneSet(0.65f)), terrainSeed, 5, 2.0f, 0.5f);
+    LaneFloat detail = FBM2DLanes(LaneMul(warpedX, LaneSet(2.3f)), LaneMul(warpedZ, LaneSet(2.3f)), terrainSeed + 457u, 4, 2.2f, 0.45f);
+    LaneFloat ridges = RidgeNoise2DLanes(LaneMul(warpedX, LaneSet(1.45f)), LaneMul(warpedZ, LaneSet(1.45f)), terrainSeed + 1291u, 4, 2.0f, 0.5f);
+    LaneFloat peakMaskRaw = FBM2DLanes(LaneMul(warpedX, LaneSet(0.22f)), LaneMul(warpedZ, LaneSet(0.22f)), terrainSeed + 2903u, 3, 2.0f, 0.55f);
+    LaneFloat peakMask = Saturate(LaneDiv(LaneSub(peakMaskRaw, LaneSet(0.45f)), LaneSet(0.55f)));
+    peakMask = LaneMul(peakMask, peakMask);
+    LaneFloat tallPeaks = LaneMul(RidgeNoise2DLanes(LaneMul(warpedX, LaneSet(0.85f)), LaneMul(warpedZ, LaneSet(0.85f)),
+                                                    terrainSeed + 3761u, 4, 2.1f, 0.5f), peakMask);
+    LaneFloat heightShape = LaneAdd(LaneAdd(LaneAdd(LaneMul(macro, LaneSet(0.75f)), LaneMul(detail, LaneSet(0.30f))),
+                                            LaneMul(LaneSub(LaneMul(ridges, LaneSet(2.0f)), LaneSet(1.0f)), LaneSet(0.65f))),
+                                    LaneMul(tallPeaks, LaneSet(1.6f)));
+    LaneFloat heightValue = LaneMul(heightShape, LaneSet(scene->terrainHeightScale * 1.55f));
+    LaneFloat extremePeakMask = Saturate(LaneDiv(LaneSub(peakMask, LaneSet(0.90f)), LaneSet(0.10f)));
+    heightValue = LaneMul(heightValue, LaneAdd(LaneSet(1.0f), LaneMul(LaneSet(0.70f), extremePeakMask)));
+    LaneStore(out, heightValue);
+}
+#endif
+
+typedef struct {
+    const Scene* scene;
+    int firstX;              // Sample coordinates of apron[0]
+    int firstZ;
+    float* apron;
+} TerrainApronJob;
+
+// Rows [begin, end) of the apron; NOISE_LANES samples at a time, scalar for the remainder
+static void GenerateTerrainApronRows(void* userData, int begin, int end, int threadIndex) {
+    (void)threadIndex;
+    const TerrainApronJob* job = (const TerrainApronJob*)userData;
+    const int apronSide = TERRAIN_TILE_SAMPLES + 2;
+    for (int z = begin; z < end; z++) {
+        float* row = job->apron + z * apronSide;
+        int x = 0;
+#ifdef NOISE_LANES
+        for (; x + NOISE_LANES <= apronSide; x += NOISE_LANES) {
+            GenerateTerrainHeightLanes(job->scene, job->firstX + x, job->firstZ + z, row + x);
+        }
+#endif
+        for (; x < apronSide; x++) {
+            row[x] = GenerateTerrainHeight(job->scene, job->firstX + x, job->firstZ + z);
+        }
+    }
+}
+
+void GenerateTerrainTile(const Scene* scene, int tileX, int tileZ, JobSystem* jobs, TerrainTileData* out) {
+    const int side = TERRAIN_TILE_SAMPLES;
+    const int apronSide = TERRAIN_TILE_SAMPLES + 2;
+    out->tileX = tileX;
+    out->tileZ = tileZ;
+
+    // One sample of border so edge normals match the neighbouring tile's
+    TerrainApronJob job = { scene, tileX * WORLD_TILE_QUADS - 1, tileZ * WORLD_TILE_QUADS - 1, out->apron };
+    RunParallelFor(jobs, apronSide, TERRAIN_GENERATE_ROW_GRAIN, GenerateTerrainApronRows, &job);
+
+    float cell = scene->terrainCellSize;
+    for (int z = 0; z < side; z++) {
+        const float* row = out->apron + (z + 1) * apronSide + 1;
+        for (int x = 0; x < side; x++) {
+            out->heights[z * side + x] = row[x];
+            float hL = row[x - 1];
+            float hR = row[x + 1];
+            float hD = row[x - apronSide];
+            float hU = row[x + apronSide];
+            Vector3 normal = Vector3Normalize((Vector3){ -(hR - hL) / (2.0f * cell), 1.0f, -(hU - hD) / (2.0f * cell) });
+            unsigned char* texel = out->normals + (z * side + x) * 4;
+            texel[0] = (unsigned char)(normal.x * 127.5f + 127.5f);
+            texel[1] = (unsigned char)(normal.y * 127.5f + 127.5f);
+            texel[2] = (unsigned char)(normal.z * 127.5f + 127.5f);
+            texel[3] = 255;
+        }
+    }
+}
+
+// Max-height pyramid layout shared by every slot: level 0 is one entry per heightfield cell
+static void LayoutTerrainMaxPyramid(Scene* scene) {
+    int width = WORLD_TILE_QUADS;
+    int total = 0;
+    int levels = 0;
+    for (;;) {
+        scene->terrainMaxLevelOffset[levels] = total;
+        scene->terrainMaxLevelWidth[levels] = width;
+        total += width * width;
+        levels++;
+        if (width == 1 || levels == TERRAIN_MAX_PYRAMID_LEVELS) break;
+        width = (width + 1) / 2;
+    }
+    scene->terrainMaxLevelCount = levels;
+    scene->terrainMaxPyramidSize = total;
+    scene->terrainMaxPyramid = (float*)malloc((size_t)total * TERRAIN_TILE_SLOTS * sizeof(float));
+}
+
+static void BuildTerrainMaxPyramid(Scene* scene, int slot) {
+    const float* heights = scene->terrainHeights + slot * TERRAIN_TILE_SAMPLES * TERRAIN_TILE_SAMPLES;
+    float* pyramid = scene->terrainMaxPyramid + slot * scene->terrainMaxPyramidSize;
+    for (int z = 0; z < WORLD_TILE_QUADS; z++) {
+        for (int x = 0; x < WORLD_TILE_QUADS; x++) {
+            const float* row0 = heights + z * TERRAIN_TILE_SAMPLES + x;
+            const float* row1 = row0 + TERRAIN_TILE_SAMPLES;
+            pyramid[z * WORLD_TILE_QUADS + x] = fmaxf(fmaxf(row0[0], row0[1]), fmaxf(row1[0], row1[1]));
+        }
+    }
+
+    for (int level = 1; level < scene->terrainMaxLevelCount; level++) {
+        const float* src = pyramid + scene->terrainMaxLevelOffset[level - 1];
+        float* dst = pyramid + scene->terrainMaxLevelOffset[level];
+        int srcW = scene->terrainMaxLevelWidth[level - 1];
+        int w = scene->terrainMaxLevelWidth[level];
+        for (int z = 0; z < w; z++) {
+            for (int x = 0; x < w; x++) {
+                int x0 = x * 2, z0 = z * 2;
+                int x1 = (x0 + 1 < srcW) ? x0 + 1 : x0;
+                int z1 = (z0 + 1 < srcW) ? z0 + 1 : z0;
+                dst[z * w + x] = fmaxf(fmaxf(src[z0 * srcW + x0], src[z0 * srcW + x1]),
+                                       fmaxf(src[z1 * srcW + x0], src[z1 * srcW + x1]));
+            }
+        }
+    }
+}
+
+// Node layout and LOD ranges for one tile's quadtree. Needs WORLD_TILE_QUADS = TERRAIN_PATCH_QUADS * 2^n.
+static bool LayoutTerrainLodTree(Scene* scene) {
+    int leaves = WORLD_TILE_QUADS / TERRAIN_PATCH_QUADS;
+    if (WORLD_TILE_QUADS % TERRAIN_PATCH_QUADS != 0 || (leaves & (leaves - 1)) != 0) return false;
+    int levels = 1;
+    while ((1 << (levels - 1)) < leaves) levels++;
+    if (levels > TERRAIN_LOD_MAX_LEVELS) return false;
+
+    int total = 0;
+    for (int level = 0; level < levels; level++) {
+        scene->terrainNodeLevelOffset[level] = total;
+        scene->terrainNodeLevelWidth[level] = leaves >> level;
+        total += scene->terrainNodeLevelWidth[level] * scene->terrainNodeLevelWidth[level];
+    }
+    scene->terrainLodLevelCount = levels;
+    scene->terrainNodeCount = total;
+    scene->terrainNodeMinY = (float*)malloc((size_t)total * TERRAIN_TILE_SLOTS * sizeof(float));
+    scene->terrainNodeMaxY = (float*)malloc((size_t)total * TERRAIN_TILE_SLOTS * sizeof(float));
+
+    for (int level = 0; level < levels; level++) {
+        scene->terrainLodRange[level] = TERRAIN_LOD_NEAR_RANGE * (float)(1 << level);
+    }
+    scene->terrainLodRange[levels - 1] = INFINITY;
+    scene->terrainNodeCapacity = leaves * leaves * TERRAIN_TILE_SLOTS;
+    scene->terrainNodeData = (float*)malloc((size_t)scene->terrainNodeCapacity * 4 * sizeof(float));
+    scene->terrainTileData = (float*)malloc((size_t)scene->terrainNodeCapacity * 4 * sizeof(float));
+    return true;
+}
+
+// Per-node height bounds of one slot, every quadtree level
+static void BuildTerrainNodeBounds(Scene* scene, int slot) {
+    const float* heights = scene->terrainHeights + slot * TERRAIN_TILE_SAMPLES * TERRAIN_TILE_SAMPLES;
+    float* minY = scene->terrainNodeMinY + slot * scene->terrainNodeCount;
+    float* maxY = scene->terrainNodeMaxY + slot * scene->terrainNodeCount;
+    int leaves = scene->terrainNodeLevelWidth[0];
+
+    // Leaves cover their edge vertices too, so shared rows count toward both neighbours
+    for (int nz = 0; nz < leaves; nz++) {
+        for (int nx = 0; nx < leaves; nx++) {
+            float lo = INFINITY;
+            float hi = -INFINITY;
+            for (int z = nz * TERRAIN_PATCH_QUADS; z <= (nz + 1) * TERRAIN_PATCH_QUADS; z++) {
+                const float* row = heights + z * TERRAIN_TILE_SAMPLES;
+                for (int x = nx * TERRAIN_PATCH_QUADS; x <= (nx + 1) * TERRAIN_PATCH_QUADS; x++) {
+                    lo = fminf(lo, row[x]);
+                    hi = fmaxf(hi, row[x]);
+                }
+            }
+            minY[nz * leaves + nx] = lo;
+            maxY[nz * leaves + nx] = hi;
+        }
+    }
+    for (int level = 1; level < scene->terrainLodLevelCount; level++) {
+        int w = scene->terrainNodeLevelWidth[level];
+        int childW = scene->terrainNodeLevelWidth[level - 1];
+        const float* childMin = minY + scene->terrainNodeLevelOffset[level - 1];
+        const float* childMax = maxY + scene->terrainNodeLevelOffset[level - 1];
+        float* dstMin = minY + scene->terrainNodeLevelOffset[level];
+        float* dstMax = maxY + scene->terrainNodeLevelOffset[level];
+        for (int nz = 0; nz < w; nz++) {
+            for (int nx = 0; nx < w; nx++) {
+                int c = (nz * 2) * childW + nx * 2;
+                dstMin[nz * w + nx] = fminf(fminf(childMin[c], childMin[c + 1]), fminf(childMin[c + childW], childMin[c + childW + 1]));
+                dstMax[nz * w + nx] = fmaxf(fmaxf(childMax[c], childMax[c + 1]), fmaxf(childMax[c + childW], childMax[c + childW + 1]));
+            }
+        }
+    }
+}
+
+// Shared (TERRAIN_PATCH_QUADS + 1)^2 vertex grid, with the two per-node streams attached from TERRAIN_NODE_ATTRIB_LOCATION
+static void LoadTerrainPatch(Scene* scene) {
+    const int side = TERRAIN_PATCH_QUADS + 1;
+    float* grid = (float*)malloc((size_t)side * side * 2 * sizeof(float));
+    unsigned short* indices = (unsigned short*)malloc((size_t)TERRAIN_PATCH_QUADS * TERRAIN_PATCH_QUADS * 6 * sizeof(unsigned short));
+    for (int z = 0; z < side; z++) {
+        for (int x = 0; x < side; x++) {
+            grid[(z * side + x) * 2 + 0] = (float)x;
+            grid[(z * side + x) * 2 + 1] = (float)z;
+        }
+    }
+    int indexOffset = 0;
+    for (int z = 0; z < TERRAIN_PATCH_QUADS; z++) {
+        for (int x = 0; x < TERRAIN_PATCH_QUADS; x++) {
+            unsigned short i0 = (unsigned short)(z * side + x);
+            unsigned short i1 = (unsigned short)(z * side + x + 1);
+            unsigned short i2 = (unsigned short)((z + 1) * side + x);
+            unsigned short i3 = (unsigned short)((z + 1) * side + x + 1);
+            indices[indexOffset++] = i0;
+            indices[indexOffset++] = i2;
+            indices[indexOffset++] = i1;
+            indices[indexOffset++] = i1;
+            indices[indexOffset++] = i2;
+            indices[indexOffset++] = i3;
+        }
+    }
+    scene->terrainPatchIndexCount = indexOffset;
+
+    scene->terrainPatchVao = rlLoadVertexArray();
+    rlEnableVertexArray(scene->terrainPatchVao);
+    scene->terrainPatchVbo = rlLoadVertexBuffer(grid, side * side * 2 * (int)sizeof(float), false);
+    rlSetVertexAttribute(0, 2, RL_FLOAT, false, 0, 0); // vertexPosition
+    rlEnableVertexAttribute(0);
+    scene->terrainPatchIbo = rlLoadVertexBufferElement(indices, indexOffset * (int)sizeof(unsigned short), false);
+    scene->terrainNodeVbo = rlLoadVertexBuffer(NULL, scene->terrainNodeCapacity * 4 * (int)sizeof(float), true);
+    rlSetVertexAttribute(TERRAIN_NODE_ATTRIB_LOCATION, 4, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(TERRAIN_NODE_ATTRIB_LOCATION);
+    rlSetVertexAttributeDivisor(TERRAIN_NODE_ATTRIB_LOCATION, 1);
+    scene->terrainTileVbo = rlLoadVertexBuffer(NULL, scene->terrainNodeCapacity * 4 * (int)sizeof(float), true);
+    rlSetVertexAttribute(TERRAIN_NODE_ATTRIB_LOCATION + 1, 4, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(TERRAIN_NODE_ATTRIB_LOCATION + 1);
+    rlSetVertexAttributeDivisor(TERRAIN_NODE_ATTRIB_LOCATION + 1, 1);
+    rlDisableVertexBuffer();
+    rlDisableVertexArray(); // Before anything unbinds the element buffer, so the VAO keeps it
+    free(grid);
+    free(indices);
+}
+
+// Empty atlas with one TERRAIN_TILE_SAMPLES square per slot; tiles are written in as they commit
+static Texture2D LoadTerrainAtlas(int format) {
+    Texture2D atlas = {0};
+    atlas.width = WORLD_WINDOW_TILES * TERRAIN_TILE_SAMPLES;
+    atlas.height = WORLD_WINDOW_TILES * TERRAIN_TILE_SAMPLES;
+    atlas.id = rlLoadTexture(NULL, atlas.width, atlas.height, format, 1);
+    atlas.format = format;
+    atlas.mipmaps = 1;
+    return atlas;
+}
+
+// Quadtree layout, patch, atlases and the uniforms that never change
+static bool LoadTerrainLod(Scene* scene) {
+    if (!LayoutTerrainLodTree(scene)) return false;
+    LoadTerrainPatch(scene);
+    scene->terrainHeightTexture = LoadTerrainAtlas(PIXELFORMAT_UNCOMPRESSED_R32);
+    scene->terrainNormalTexture = LoadTerrainAtlas(PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+    Shader shader = scene->terrainShader;
+    scene->terrainShaderLocs[0] = GetShaderLocation(shader, "heightMap");
+    scene->terrainShaderLocs[1] = GetShaderLocation(shader, "normalMap");
+    scene->terrainShaderLocs[2] = GetShaderLocation(shader, "tileSamples");
+    scene->terrainShaderLocs[3] = GetShaderLocation(shader, "terrainCellSize");
+    scene->terrainShaderLocs[4] = GetShaderLocation(shader, "morphRange");
+    int tileSamples = TERRAIN_TILE_SAMPLES;
+    float cellSize = scene->terrainCellSize;
+    Vector2 morphRange[TERRAIN_LOD_MAX_LEVELS] = {0};
+    for (int level = 0; level < scene->terrainLodLevelCount - 1; level++) {
+        float start = (level > 0) ? scene->terrainLodRange[level - 1] : 0.0f;
+        float end = scene->terrainLodRange[level];
+        morphRange[level] = (Vector2){ start + (end - start) * TERRAIN_LOD_MORPH_START, end };
+    }
+    morphRange[scene->terrainLodLevelCount - 1] = (Vector2){ 1e30f, 2e30f }; // The top level never morphs
+    SetShaderValue(shader, scene->terrainShaderLocs[2], &tileSamples, SHADER_UNIFORM_INT);
+    SetShaderValue(shader, scene->terrainShaderLocs[3], &cellSize, SHADER_UNIFORM_FLOAT);
+    SetShaderValueV(shader, scene->terrainShaderLocs[4], morphRange, SHADER_UNIFORM_VEC2, TERRAIN_LOD_MAX_LEVELS);
+    return true;
+}
+
+// Full-resolution mesh of one tile (129^2 vertices fits 16-bit indices) for the no-shader fallback
+static Model LoadTerrainFallbackModel(const Scene* scene, const TerrainTileData* tile) {
+    const int side = TERRAIN_TILE_SAMPLES;
+    const int terrainVertexCount = side * side;
+    const int terrainQuadCount = WORLD_TILE_QUADS * WORLD_TILE_QUADS;
+    Mesh terrainMesh = {0};
+    terrainMesh.vertexCount = terrainVertexCount;
+    terrainMesh.triangleCount = terrainQuadCount * 2;
+    terrainMesh.vertices = (float*)MemAlloc((size_t)terrainVertexCount * 3 * sizeof(float));
+    terrainMesh.texcoords = (float*)MemAlloc((size_t)terrainVertexCount * 2 * sizeof(float));
+    terrainMesh.normals = (float*)MemAlloc((size_t)terrainVertexCount * 3 * sizeof(float));
+    terrainMesh.indices = (unsigned short*)MemAlloc((size_t)terrainQuadCount * 6 * sizeof(unsigned short));
+
+    float startX = (float)tile->tileX * WORLD_TILE_SIZE;
+    float startZ = (float)tile->tileZ * WORLD_TILE_SIZE;
+    float uvPerMeter = TERRAIN_UV_REPEAT / 500.0f;
+    for (int z = 0; z < side; z++) {
+        for (int x = 0; x < side; x++) {
+            int index = z * side + x;
+            float worldX = startX + (float)x * scene->terrainCellSize;
+            float worldZ = startZ + (float)z * scene->terrainCellSize;
+            const unsigned char* normal = tile->normals + index * 4;
+            terrainMesh.vertices[index * 3 + 0] = worldX;
+            terrainMesh.vertices[index * 3 + 1] = tile->heights[index];
+            terrainMesh.vertices[index * 3 + 2] = worldZ;
+            terrainMesh.texcoords[index * 2 + 0] = worldX * uvPerMeter;
+            terrainMesh.texcoords[index * 2 + 1] = worldZ * uvPerMeter;
+            terrainMesh.normals[index * 3 + 0] = (float)normal[0] / 127.5f - 1.0f;
+            terrainMesh.normals[index * 3 + 1] = (float)normal[1] / 127.5f - 1.0f;
+            terrainMesh.normals[index * 3 + 2] = (float)normal[2] / 127.5f - 1.0f;
+        }
+    }
+
+    int indexOffset = 0;
+    for (int z = 0; z < side - 1; z++) {
+        for (int x = 0; x < side - 1; x++) {
+            unsigned short i0 = (unsigned short)(z * side + x);
+            unsigned short i1 = (unsigned short)(z * side + x + 1);
+            unsigned short i2 = (unsigned short)((z + 1) * side + x);
+            unsigned short i3 = (unsigned short)((z + 1) * side + x + 1);
+            terrainMesh.indices[indexOffset++] = i0;
+            terrainMesh.indices[indexOffset++] = i2;
+            terrainMesh.indices[indexOffset++] = i1;
+            terrainMesh.indices[indexOffset++] = i1;
+            terrainMesh.indices[indexOffset++] = i2;
+            terrainMesh.indices[indexOffset++] = i3;
+        }
+    }
+
+    GenMeshTangents(&terrainMesh);
+    UploadMesh(&terrainMesh, false);
+    Model model = LoadModelFromMesh(terrainMesh);
+
+    // Assign textures to models
+    if (scene->floorTexture.id > 0) model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = scene->floorTexture;
+    else model.materials[0].maps[MATERIAL_MAP_DIFFUSE].color = GRAY; // Fallback color
+    if (scene->floorNormalMap.id > 0) model.materials[0].maps[MATERIAL_MAP_NORMAL].texture = scene->floorNormalMap;
+    if (model.materialCount > 0) model.materials[0].shader = scene->lightingShader;
+    return model;
+}
+
+Scene InitScene(float width, float length, float height, float thickness,
+                const char* wallTexturePath, const char* floorTexturePath, Shader lightingShader, Shader terrainShader,
+                unsigned int terrainSeed) {
     Scene scene = {0};
-    
+
     // Store dimensions
     scene.roomWidth = width;
     scene.roomLength = length;
     scene.wallHeight = height;
     scene.wallThickness = thickness;
-    
+
     // Surrounding walls are temporarily disabled.
     scene.wallTexture = (Texture2D){0};
     scene.floorTexture = LoadTexture(floorTexturePath);
@@ -102,13 +652,13 @@ Scene InitScene(float width, float length, float height, float thickness,
             printf("Floor normal map not found: %s\n", floorNormalPath);
         }
     }
-    
+
     // Check if textures loaded successfully
     (void)wallTexturePath;
     if (scene.floorTexture.id == 0) {
         printf("Failed to load floor texture: %s\n", floorTexturePath);
     }
-    
+
     // Apply texture filtering to scene textures
     if (scene.floorTexture.id > 0) {
         SetTextureFilter(scene.floorTexture, MAIN_TEXTURE_FILTER_MODE);
@@ -118,168 +668,486 @@ Scene InitScene(float width, float length, float height, float thickness,
         SetTextureFilter(scene.floorNormalMap, MAIN_TEXTURE_FILTER_MODE);
         SetTextureWrap(scene.floorNormalMap, TEXTURE_WRAP_REPEAT);
     }
-    
-    scene.terrainWidth = 129;
-    scene.terrainLength = 129;
+
+    scene.terrainSeed = terrainSeed;
+    scene.terrainCellSize = WORLD_CELL_SIZE;
     scene.terrainHeightScale = 4.8f;
-    scene.terrainCellSizeX = width / (float)(scene.terrainWidth - 1);
-    scene.terrainCellSizeZ = length / (float)(scene.terrainLength - 1);
-    scene.terrainHeights = (float*)malloc((size_t)(scene.terrainWidth * scene.terrainLength) * sizeof(float));
+    scene.terrainHeights = (float*)malloc((size_t)TERRAIN_TILE_SLOTS * TERRAIN_TILE_SAMPLES * TERRAIN_TILE_SAMPLES * sizeof(float));
+    LayoutTerrainMaxPyramid(&scene);
 
-    const int terrainVertexCount = scene.terrainWidth * scene.terrainLength;
-    const int terrainQuadCount = (scene.terrainWidth - 1) * (scene.terrainLength - 1);
-    Mesh terrainMesh = {0};
-    terrainMesh.vertexCount = terrainVertexCount;
-    terrainMesh.triangleCount = terrainQuadCount * 2;
-    terrainMesh.vertices = (float*)MemAlloc((size_t)terrainVertexCount * 3 * sizeof(float));
-    terrainMesh.texcoords = (float*)MemAlloc((size_t)terrainVertexCount * 2 * sizeof(float));
-    terrainMesh.normals = (float*)MemAlloc((size_t)terrainVertexCount * 3 * sizeof(float));
-    terrainMesh.indices = (unsigned short*)MemAlloc((size_t)terrainQuadCount * 6 * sizeof(unsigned short));
+    scene.lightingShader = lightingShader;
+    scene.terrainShader = terrainShader;
+    if (scene.terrainShader.id > 0 && !LoadTerrainLod(&scene)) {
+        printf("ERROR: %d-cell tiles do not fit the CDLOD quadtree, using coarse per-tile meshes\n", WORLD_TILE_QUADS);
+        scene.terrainShader = (Shader){0};
+    }
+    if (scene.terrainShader.id > 0) {
+        printf("INFO: CDLOD terrain: %dx%d tiles of %d cells, %d levels of %dx%d-quad nodes\n", WORLD_WINDOW_TILES,
+               WORLD_WINDOW_TILES, WORLD_TILE_QUADS, scene.terrainLodLevelCount, TERRAIN_PATCH_QUADS, TERRAIN_PATCH_QUADS);
+    }
 
-    float startX = -width * 0.5f;
-    float startZ = -length * 0.5f;
-    for (int z = 0; z < scene.terrainLength; z++) {
-        for (int x = 0; x < scene.terrainWidth; x++) {
-            int index = z * scene.terrainWidth + x;
-            float worldX = startX + (float)x * scene.terrainCellSizeX;
-            float worldZ = startZ + (float)z * scene.terrainCellSizeZ;
-            float baseX = worldX * 0.012f;
-            float baseZ = worldZ * 0.012f;
-            float warpX = FBM2D(baseX + 37.1f, baseZ - 12.4f, terrainSeed + 911u, 3, 2.1f, 0.5f);
-            float warpZ = FBM2D(baseX - 18.6f, baseZ + 25.7f, terrainSeed + 1823u, 3, 2.1f, 0.5f);
-            float warpedX = baseX + warpX * 0.9f;
-            float warpedZ = baseZ + warpZ * 0.9f;
-            float macro = FBM2D(warpedX * 0.65f, warpedZ * 0.65f, terrainSeed, 5, 2.0f, 0.5f);
-            float detail = FBM2D(warpedX * 2.3f, warpedZ * 2.3f, terrainSeed + 457u, 4, 2.2f, 0.45f);
-            float ridges = RidgeNoise2D(warpedX * 1.45f, warpedZ * 1.45f, terrainSeed + 1291u, 4, 2.0f, 0.5f);
-            float peakMaskRaw = FBM2D(warpedX * 0.22f, warpedZ * 0.22f, terrainSeed + 2903u, 3, 2.0f, 0.55f);
-            float peakMask = Clamp((peakMaskRaw - 0.45f) / 0.55f, 0.0f, 1.0f);
-            peakMask = peakMask * peakMask;
-            float tallPeaks = RidgeNoise2D(warpedX * 0.85f, warpedZ * 0.85f, terrainSeed + 3761u, 4, 2.1f, 0.5f) * peakMask;
-            float heightShape = macro * 0.75f + detail * 0.30f + (ridges * 2.0f - 1.0f) * 0.65f + tallPeaks * 1.6f;
-            float heightValue = heightShape * (scene.terrainHeightScale * 1.55f);
-            float extremePeakMask = Clamp((peakMask - 0.90f) / 0.10f, 0.0f, 1.0f);
-            heightValue *= (1.0f + 0.70f * extremePeakMask);
-            scene.terrainHeights[index] = heightValue;
+    scene.wallModelNS = (Model){0};
+    scene.wallModelEW = (Model){0};
 
-            terrainMesh.vertices[index * 3 + 0] = worldX;
-            terrainMesh.vertices[index * 3 + 1] = heightValue;
-            terrainMesh.vertices[index * 3 + 2] = worldZ;
-            terrainMesh.texcoords[index * 2 + 0] = ((float)x / (float)(scene.terrainWidth - 1)) * TERRAIN_UV_REPEAT;
-            terrainMesh.texcoords[index * 2 + 1] = ((float)z / (float)(scene.terrainLength - 1)) * TERRAIN_UV_REPEAT;
-        }
-    }
+    scene.numWalls = 0;
+    scene.wallBoxes = NULL;
 
-    for (int z = 0; z < scene.terrainLength; z++) {
-        for (int x = 0; x < scene.terrainWidth; x++) {
-            int ixL = (x > 0) ? x - 1 : x;
-            int ixR = (x < scene.terrainWidth - 1) ? x + 1 : x;
-            int izD = (z > 0) ? z - 1 : z;
-            int izU = (z < scene.terrainLength - 1) ? z + 1 : z;
-            float hL = scene.terrainHeights[z * scene.terrainWidth + ixL];
-            float hR = scene.terrainHeights[z * scene.terrainWidth + ixR];
-            float hD = scene.terrainHeights[izD * scene.terrainWidth + x];
-            float hU = scene.terrainHeights[izU * scene.terrainWidth + x];
-            Vector3 normal = Vector3Normalize((Vector3){
-                -(hR - hL) / (2.0f * scene.terrainCellSizeX),
-                1.0f,
-                -(hU - hD) / (2.0f * scene.terrainCellSizeZ)
-            });
-            int index = z * scene.terrainWidth + x;
-            terrainMesh.normals[index * 3 + 0] = normal.x;
-            terrainMesh.normals[index * 3 + 1] = normal.y;
-            terrainMesh.normals[index * 3 + 2] = normal.z;
-        }
+    return scene;
+}
+
+void CommitTerrainTile(Scene* scene, const TerrainTileData* tile) {
+    const int side = TERRAIN_TILE_SAMPLES;
+    int slot = GetWorldTileSlot(tile->tileX, tile->tileZ);
+    EvictTerrainTile(scene, slot);
+    memcpy(scene->terrainHeights + slot * side * side, tile->heights, sizeof(tile->heights));
+    BuildTerrainMaxPyramid(scene, slot);
+
+    if (scene->terrainShader.id > 0) {
+        BuildTerrainNodeBounds(scene, slot);
+        int atlasX = (slot % WORLD_WINDOW_TILES) * side;
+        int atlasY = (slot / WORLD_WINDOW_TILES) * side;
+        rlUpdateTexture(scene->terrainHeightTexture.id, atlasX, atlasY, side, side, PIXELFORMAT_UNCOMPRESSED_R32, tile->heights);
+        rlUpdateTexture(scene->terrainNormalTexture.id, atlasX, atlasY, side, side, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, tile->normals);
+    } else {
+        scene->terrainModels[slot] = LoadTerrainFallbackModel(scene, tile);
     }
+    scene->terrainTiles[slot] = (TerrainTileSlot){ tile->tileX, tile->tileZ, true };
+}
 
-    int indexOffset = 0;
-    for (int z = 0; z < scene.terrainLength - 1; z++) {
-        for (int x = 0; x < scene.terrainWidth - 1; x++) {
-            unsigned short i0 = (unsigned short)(z * scene.terrainWidth + x);
-            unsigned short i1 = (unsigned short)(z * scene.terrainWidth + x + 1);
-            unsigned short i2 = (unsigned short)((z + 1) * scene.terrainWidth + x);
-            unsigned short i3 = (unsigned short)((z + 1) * scene.terrainWidth + x + 1);
-            terrainMesh.indices[indexOffset++] = i0;
-            terrainMesh.indices[indexOffset++] = i2;
-            terrainMesh.indices[indexOffset++] = i1;
-            terrainMesh.indices[indexOffset++] = i1;
-            terrainMesh.indices[indexOffset++] = i2;
-            terrainMesh.indices[indexOffset++] = i3;
+void EvictTerrainTile(Scene* scene, int slot) {
+    if (scene->terrainModels[slot].meshCount > 0) UnloadModel(scene->terrainModels[slot]);
+    scene->terrainModels[slot] = (Model){0};
+    scene->terrainTiles[slot].resident = false;
+}
+
+bool IsTerrainTileResident(const Scene* scene, int tileX, int tileZ) {
+    const TerrainTileSlot* tile = &scene->terrainTiles[GetWorldTileSlot(tileX, tileZ)];
+    return tile->resident && tile->tileX == tileX && tile->tileZ == tileZ;
+}
+
+static float BoxDistanceSqr(BoundingBox box, Vector3 p) {
+    float dx = fmaxf(fmaxf(box.min.x - p.x, 0.0f), p.x - box.max.x);
+    float dy = fmaxf(fmaxf(box.min.y - p.y, 0.0f), p.y - box.max.y);
+    float dz = fmaxf(fmaxf(box.min.z - p.z, 0.0f), p.z - box.max.z);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+static BoundingBox GetTerrainNodeBounds(const Scene* scene, int slot, int level, int nx, int nz) {
+    int span = TERRAIN_PATCH_QUADS << level;
+    int node = slot * scene->terrainNodeCount + scene->terrainNodeLevelOffset[level] + nz * scene->terrainNodeLevelWidth[level] + nx;
+    const TerrainTileSlot* tile = &scene->terrainTiles[slot];
+    float minX = (float)tile->tileX * WORLD_TILE_SIZE + (float)(nx * span) * scene->terrainCellSize;
+    float minZ = (float)tile->tileZ * WORLD_TILE_SIZE + (float)(nz * span) * scene->terrainCellSize;
+    return (BoundingBox){
+        .min = { minX, scene->terrainNodeMinY[node], minZ },
+        .max = { minX + (float)span * scene->terrainCellSize, scene->terrainNodeMaxY[node], minZ + (float)span * scene->terrainCellSize }
+    };
+}
+
+// CDLOD selection: a node that reaches into the next finer level's range is split, otherwise it is
+// drawn at its own level. Children drawn beyond their range come out fully morphed to this level.
+static void SelectTerrainNode(Scene* scene, const Frustum* frustum, Vector3 cameraPosition, int slot, int level, int nx, int nz) {
+    BoundingBox bounds = GetTerrainNodeBounds(scene, slot, level, nx, nz);
+    if (!IsBoxInFrustum(frustum, bounds)) return;
+    if (level > 0) {
+        float childRange = scene->terrainLodRange[level - 1];
+        if (BoxDistanceSqr(bounds, cameraPosition) < childRange * childRange) {
+            for (int iz = 0; iz < 2; iz++) {
+                for (int ix = 0; ix < 2; ix++) SelectTerrainNode(scene, frustum, cameraPosition, slot, level - 1, nx * 2 + ix, nz * 2 + iz);
+            }
+            return;
         }
     }
+    const TerrainTileSlot* tile = &scene->terrainTiles[slot];
+    float spacing = (float)(1 << level);
+    float* node = scene->terrainNodeData + scene->terrainNodesDrawn * 4;
+    node[0] = (float)(nx * TERRAIN_PATCH_QUADS) * spacing;
+    node[1] = (float)(nz * TERRAIN_PATCH_QUADS) * spacing;
+    node[2] = spacing;
+    node[3] = (float)level;
+    float* tileData = scene->terrainTileData + scene->terrainNodesDrawn * 4;
+    tileData[0] = (float)tile->tileX * WORLD_TILE_SIZE;
+    tileData[1] = (float)tile->tileZ * WORLD_TILE_SIZE;
+    tileData[2] = (float)((slot % WORLD_WINDOW_TILES) * TERRAIN_TILE_SAMPLES);
+    tileData[3] = (float)((slot / WORLD_WINDOW_TILES) * TERRAIN_TILE_SAMPLES);
+    scene->terrainNodesDrawn++;
+}
 
-    GenMeshTangents(&terrainMesh);
-    UploadMesh(&terrainMesh, false);
-    scene.terrainModel = LoadModelFromMesh(terrainMesh);
-    scene.floorModel = scene.terrainModel;
+// Every selected node in one instanced draw of the shared patch
+static void DrawTerrainNodes(Scene* scene) {
+    Shader shader = scene->terrainShader;
+    rlDrawRenderBatchActive(); // Flush batched immediate-mode geometry (skybox) before raw draws
+    rlUpdateVertexBuffer(scene->terrainNodeVbo, scene->terrainNodeData, scene->terrainNodesDrawn * 4 * (int)sizeof(float), 0);
+    rlUpdateVertexBuffer(scene->terrainTileVbo, scene->terrainTileData, scene->terrainNodesDrawn * 4 * (int)sizeof(float), 0);
 
-    scene.wallModelNS = (Model){0};
-    scene.wallModelEW = (Model){0};
-    
-    // Assign textures to models
-    if (scene.floorTexture.id > 0) scene.terrainModel.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = scene.floorTexture;
-    else scene.terrainModel.materials[0].maps[MATERIAL_MAP_DIFFUSE].color = GRAY; // Fallback color
-    if (scene.floorNormalMap.id > 0) scene.terrainModel.materials[0].maps[MATERIAL_MAP_NORMAL].texture = scene.floorNormalMap;
-    
-    // Assign lighting shader to all scene models' materials with safety checks
-    if (scene.terrainModel.materialCount > 0) {
-        scene.terrainModel.materials[0].shader = lightingShader;
+    rlEnableShader(shader.id);
+    Matrix viewProjection = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], viewProjection);
+    int albedoSlot = 0;
+    int normalSlot = 1;
+    int heightSlot = 2;
+    int terrainNormalSlot = 3;
+    rlActiveTextureSlot(albedoSlot);
+    rlEnableTexture(scene->floorTexture.id > 0 ? scene->floorTexture.id : rlGetTextureIdDefault());
+    rlSetUniform(shader.locs[SHADER_LOC_MAP_ALBEDO], &albedoSlot, RL_SHADER_UNIFORM_INT, 1);
+    rlActiveTextureSlot(normalSlot);
+    rlEnableTexture(scene->floorNormalMap.id);
+    rlSetUniform(shader.locs[SHADER_LOC_MAP_NORMAL], &normalSlot, RL_SHADER_UNIFORM_INT, 1);
+    rlActiveTextureSlot(heightSlot);
+    rlEnableTexture(scene->terrainHeightTexture.id);
+    rlSetUniform(scene->terrainShaderLocs[0], &heightSlot, RL_SHADER_UNIFORM_INT, 1);
+    rlActiveTextureSlot(terrainNormalSlot);
+    rlEnableTexture(scene->terrainNormalTexture.id);
+    rlSetUniform(scene->terrainShaderLocs[1], &terrainNormalSlot, RL_SHADER_UNIFORM_INT, 1);
+
+    if (rlEnableVertexArray(scene->terrainPatchVao)) {
+        rlDrawVertexArrayElementsInstanced(0, scene->terrainPatchIndexCount, 0, scene->terrainNodesDrawn);
+        rlDisableVertexArray();
     }
-    ApplyTextureFilterToAllMaterialMaps(scene.terrainModel, MAIN_TEXTURE_FILTER_MODE);
 
-    scene.numWalls = 0;
-    scene.wallBoxes = NULL;
-    
-    return scene;
+    rlActiveTextureSlot(terrainNormalSlot);
+    rlDisableTexture();
+    rlActiveTextureSlot(heightSlot);
+    rlDisableTexture();
+    rlActiveTextureSlot(normalSlot);
+    rlDisableTexture();
+    rlActiveTextureSlot(albedoSlot);
+    rlDisableTexture();
+    rlDisableShader();
 }
 
-void DrawScene(Scene scene) {
-    DrawModel(scene.terrainModel, (Vector3){ 0.0f, 0.0f, 0.0f }, 1.0f, WHITE);
+void DrawScene(Scene* scene, Camera3D camera) {
+    if (scene->terrainShader.id == 0) {
+        for (int slot = 0; slot < TERRAIN_TILE_SLOTS; slot++) {
+            if (scene->terrainModels[slot].meshCount > 0) DrawModel(scene->terrainModels[slot], (Vector3){ 0.0f, 0.0f, 0.0f }, 1.0f, WHITE);
+        }
+        return;
+    }
+    float aspect = (float)GetScreenWidth() / (float)GetScreenHeight();
+    Frustum frustum = ExtractCameraFrustum(camera, aspect);
+    scene->terrainNodesDrawn = 0;
+    for (int slot = 0; slot < TERRAIN_TILE_SLOTS; slot++) {
+        if (!scene->terrainTiles[slot].resident) continue;
+        SelectTerrainNode(scene, &frustum, camera.position, slot, scene->terrainLodLevelCount - 1, 0, 0);
+    }
+    if (scene->terrainNodesDrawn > 0) DrawTerrainNodes(scene);
 }
 
-void DrawSceneDebug(Scene scene) {
+void DrawSceneDebug(const Scene* scene) {
     // Draw collision boxes for walls
-    for (int i = 0; i < scene.numWalls; i++) {
-        DrawBoundingBox(scene.wallBoxes[i], RED);
+    for (int i = 0; i < scene->numWalls; i++) {
+        DrawBoundingBox(scene->wallBoxes[i], RED);
     }
 }
 
-float GetTerrainHeightAt(Scene scene, float x, float z) {
-    float minX = -scene.roomWidth * 0.5f;
-    float minZ = -scene.roomLength * 0.5f;
-    float gx = (x - minX) / scene.terrainCellSizeX;
-    float gz = (z - minZ) / scene.terrainCellSizeZ;
-    gx = Clamp(gx, 0.0f, (float)(scene.terrainWidth - 1));
-    gz = Clamp(gz, 0.0f, (float)(scene.terrainLength - 1));
+// Bilinear height and surface normal inside one heightfield cell from its corners h00, h10, h01, h11.
+// The lane versions repeat these operations in the same order, so batch results do not depend on
+// which lane or tail a point lands in.
+static float BilinearHeight(const float h[4], float tx, float tz) {
+    return Lerp(Lerp(h[0], h[1], tx), Lerp(h[2], h[3], tx), tz);
+}
+
+static Vector3 BilinearNormal(const float h[4], float tx, float tz, float cellSize) {
+    float slopeX = Lerp(h[1] - h[0], h[3] - h[2], tz) / cellSize;
+    float slopeZ = Lerp(h[2] - h[0], h[3] - h[1], tx) / cellSize;
+    float length = sqrtf(slopeX * slopeX + 1.0f + slopeZ * slopeZ);
+    return (Vector3){ -slopeX / length, 1.0f / length, -slopeZ / length };
+}
+
+#ifdef NOISE_LANES
+static void GatherCellCorners(const float* heights, LaneInt index, LaneFloat h[4]) {
+    h[0] = LaneGather(heights, index);
+    h[1] = LaneGather(heights, LaneIntAdd(index, LaneIntSet(1)));
+    h[2] = LaneGather(heights, LaneIntAdd(index, LaneIntSet(TERRAIN_TILE_SAMPLES)));
+    h[3] = LaneGather(heights, LaneIntAdd(index, LaneIntSet(TERRAIN_TILE_SAMPLES + 1)));
+}
 
+// Heights and/or normals of one block of lanes into out[0 .. NOISE_LANES - 1]
+static void WriteBilinearLanes(const LaneFloat h[4], LaneFloat tx, LaneFloat tz, float cellSize, float* outHeights, Vector3* outNormals) {
+    if (outHeights != NULL) {
+        LaneStore(outHeights, LerpLanes(LerpLanes(h[0], h[1], tx), LerpLanes(h[2], h[3], tx), tz));
+    }
+    if (outNormals != NULL) {
+        LaneFloat slopeX = LaneDiv(LerpLanes(LaneSub(h[1], h[0]), LaneSub(h[3], h[2]), tz), LaneSet(cellSize));
+        LaneFloat slopeZ = LaneDiv(LerpLanes(LaneSub(h[2], h[0]), LaneSub(h[3], h[1]), tx), LaneSet(cellSize));
+        LaneFloat length = LaneSqrt(LaneAdd(LaneAdd(LaneMul(slopeX, slopeX), LaneSet(1.0f)), LaneMul(slopeZ, slopeZ)));
+        float nx[NOISE_LANES], ny[NOISE_LANES], nz[NOISE_LANES]; // -0 - s is exactly -s, signed zeros included
+        LaneStore(nx, LaneDiv(LaneSub(LaneSet(-0.0f), slopeX), length));
+        LaneStore(ny, LaneDiv(LaneSet(1.0f), length));
+        LaneStore(nz, LaneDiv(LaneSub(LaneSet(-0.0f), slopeZ), length));
+        for (int l = 0; l < NOISE_LANES; l++) outNormals[l] = (Vector3){ nx[l], ny[l], nz[l] };
+    }
+}
+#endif
+
+// Index of cell (x0, z0)'s first corner in terrainHeights, or -1 when its tile is not resident
+static int GetTerrainCellIndex(const Scene* scene, int x0, int z0) {
+    int tileX = WorldFloorDiv(x0, WORLD_TILE_QUADS);
+    int tileZ = WorldFloorDiv(z0, WORLD_TILE_QUADS);
+    if (!IsTerrainTileResident(scene, tileX, tileZ)) return -1;
+    int lx = x0 - tileX * WORLD_TILE_QUADS;
+    int lz = z0 - tileZ * WORLD_TILE_QUADS;
+    return (GetWorldTileSlot(tileX, tileZ) * TERRAIN_TILE_SAMPLES + lz) * TERRAIN_TILE_SAMPLES + lx;
+}
+
+static void QueryTerrainPoint(const Scene* scene, float x, float z, float* outHeight, Vector3* outNormal) {
+    float gx = x / scene->terrainCellSize;
+    float gz = z / scene->terrainCellSize;
     int x0 = (int)floorf(gx);
     int z0 = (int)floorf(gz);
-    int x1 = (x0 < scene.terrainWidth - 1) ? x0 + 1 : x0;
-    int z1 = (z0 < scene.terrainLength - 1) ? z0 + 1 : z0;
     float tx = gx - (float)x0;
     float tz = gz - (float)z0;
 
-    float h00 = scene.terrainHeights[z0 * scene.terrainWidth + x0];
-    float h10 = scene.terrainHeights[z0 * scene.terrainWidth + x1];
-    float h01 = scene.terrainHeights[z1 * scene.terrainWidth + x0];
-    float h11 = scene.terrainHeights[z1 * scene.terrainWidth + x1];
-    float hx0 = Lerp(h00, h10, tx);
-    float hx1 = Lerp(h01, h11, tx);
-    return Lerp(hx0, hx1, tz);
+    float h[4];
+    int index = GetTerrainCellIndex(scene, x0, z0);
+    if (index >= 0) {
+        const float* row0 = scene->terrainHeights + index;
+        h[0] = row0[0];
+        h[1] = row0[1];
+        h[2] = row0[TERRAIN_TILE_SAMPLES];
+        h[3] = row0[TERRAIN_TILE_SAMPLES + 1];
+    } else {
+        h[0] = GenerateTerrainHeight(scene, x0, z0);
+        h[1] = GenerateTerrainHeight(scene, x0 + 1, z0);
+        h[2] = GenerateTerrainHeight(scene, x0, z0 + 1);
+        h[3] = GenerateTerrainHeight(scene, x0 + 1, z0 + 1);
+    }
+    if (outHeight != NULL) *outHeight = BilinearHeight(h, tx, tz);
+    if (outNormal != NULL) *outNormal = BilinearNormal(h, tx, tz, scene->terrainCellSize);
+}
+
+// Shared body of GetTerrainHeights/GetTerrainNormals; either output may be NULL
+static void QueryTerrain(const Scene* scene, const float* xs, const float* zs, int count, float* outHeights, Vector3* outNormals) {
+    int i = 0;
+#ifdef NOISE_LANES
+    LaneFloat cellSize = LaneSet(scene->terrainCellSize);
+    for (; i + NOISE_LANES <= count; i += NOISE_LANES) {
+        LaneFloat gx = LaneDiv(LaneLoad(xs + i), cellSize);
+        LaneFloat gz = LaneDiv(LaneLoad(zs + i), cellSize);
+        LaneFloat fx = LaneFloor(gx);
+        LaneFloat fz = LaneFloor(gz);
+        int x0[NOISE_LANES], z0[NOISE_LANES], index[NOISE_LANES];
+        LaneIntStore(x0, LaneToInt(fx));
+        LaneIntStore(z0, LaneToInt(fz));
+        int missing = 0;
+        for (int l = 0; l < NOISE_LANES; l++) {
+            index[l] = GetTerrainCellIndex(scene, x0[l], z0[l]);
+            if (index[l] < 0) {
+                index[l] = 0; // Gathered harmlessly, then redone from the generator below
+                missing |= 1 << l;
+            }
+        }
+        LaneFloat h[4];
+        GatherCellCorners(scene->terrainHeights, LaneIntLoad(index), h);
+        WriteBilinearLanes(h, LaneSub(gx, fx), LaneSub(gz, fz), scene->terrainCellSize,
+                           (outHeights != NULL) ? outHeights + i : NULL, (outNormals != NULL) ? outNormals + i : NULL);
+        for (int l = 0; missing != 0 && l < NOISE_LANES; l++) {
+            if ((missing & (1 << l)) == 0) continue;
+            QueryTerrainPoint(scene, xs[i + l], zs[i + l], (outHeights != NULL) ? outHeights + i + l : NULL,
+                              (outNormals != NULL) ? outNormals + i + l : NULL);
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        QueryTerrainPoint(scene, xs[i], zs[i], (outHeights != NULL) ? outHeights + i : NULL, (outNormals != NULL) ? outNormals + i : NULL);
+    }
+}
+
+void GetTerrainHeights(const Scene* scene, const float* xs, const float* zs, int count, float* outHeights) {
+    QueryTerrain(scene, xs, zs, count, outHeights, NULL);
+}
+
+void GetTerrainNormals(const Scene* scene, const float* xs, const float* zs, int count, Vector3* outNormals) {
+    QueryTerrain(scene, xs, zs, count, NULL, outNormals);
+}
+
+float GetTerrainHeightAt(const Scene* scene, float x, float z) {
+    float height;
+    QueryTerrainPoint(scene, x, z, &height, NULL);
+    return height;
+}
+
+// Tile-local cell of a position in tile samples, clamped so the cell's corners stay inside the tile
+static int GetTileCellIndex(float gx, float gz, float* tx, float* tz) {
+    int x0 = (int)floorf(gx);
+    int z0 = (int)floorf(gz);
+    x0 = (x0 < 0) ? 0 : (x0 > WORLD_TILE_QUADS - 1) ? WORLD_TILE_QUADS - 1 : x0;
+    z0 = (z0 < 0) ? 0 : (z0 > WORLD_TILE_QUADS - 1) ? WORLD_TILE_QUADS - 1 : z0;
+    *tx = gx - (float)x0;
+    *tz = gz - (float)z0;
+    return z0 * TERRAIN_TILE_SAMPLES + x0;
+}
+
+static void QueryTerrainTile(const TerrainTileData* tile, const float* gxs, const float* gzs, int count, float* outHeights, Vector3* outNormals) {
+    int i = 0;
+#ifdef NOISE_LANES
+    for (; i + NOISE_LANES <= count; i += NOISE_LANES) {
+        LaneFloat gx = LaneLoad(gxs + i);
+        LaneFloat gz = LaneLoad(gzs + i);
+        LaneFloat fx = LaneMin(LaneMax(LaneFloor(gx), LaneSet(0.0f)), LaneSet((float)(WORLD_TILE_QUADS - 1)));
+        LaneFloat fz = LaneMin(LaneMax(LaneFloor(gz), LaneSet(0.0f)), LaneSet((float)(WORLD_TILE_QUADS - 1)));
+        LaneInt index = LaneIntAdd(LaneIntMul(LaneToInt(fz), LaneIntSet(TERRAIN_TILE_SAMPLES)), LaneToInt(fx));
+        LaneFloat h[4];
+        GatherCellCorners(tile->heights, index, h);
+        WriteBilinearLanes(h, LaneSub(gx, fx), LaneSub(gz, fz), WORLD_CELL_SIZE,
+                           (outHeights != NULL) ? outHeights + i : NULL, (outNormals != NULL) ? outNormals + i : NULL);
+    }
+#endif
+    for (; i < count; i++) {
+        float tx, tz;
+        const float* row0 = tile->heights + GetTileCellIndex(gxs[i], gzs[i], &tx, &tz);
+        float h[4] = { row0[0], row0[1], row0[TERRAIN_TILE_SAMPLES], row0[TERRAIN_TILE_SAMPLES + 1] };
+        if (outHeights != NULL) outHeights[i] = BilinearHeight(h, tx, tz);
+        if (outNormals != NULL) outNormals[i] = BilinearNormal(h, tx, tz, WORLD_CELL_SIZE);
+    }
+}
+
+void SampleTerrainTileHeights(const TerrainTileData* tile, const float* gxs, const float* gzs, int count, float* outHeights) {
+    QueryTerrainTile(tile, gxs, gzs, count, outHeights, NULL);
+}
+
+void SampleTerrainTileNormals(const TerrainTileData* tile, const float* gxs, const float* gzs, int count, Vector3* outNormals) {
+    QueryTerrainTile(tile, gxs, gzs, count, NULL, outNormals);
+}
+
+// One segment walked through one resident tile's pyramid
+typedef struct {
+    const Scene* scene;
+    const float* heights;
+    const float* pyramid;
+    float originX;      // World XZ of the tile's sample (0, 0)
+    float originZ;
+    Vector3 from;
+    Vector3 dir;
+    float tolerance;
+} TerrainTrace;
+
+// Clip t in [*t0, *t1] to lo <= origin + dir * t <= hi
+static bool ClipSegmentSlab(float origin, float dir, float lo, float hi, float* t0, float* t1) {
+    if (fabsf(dir) < 1e-8f) return origin >= lo && origin <= hi;
+    float ta = (lo - origin) / dir;
+    float tb = (hi - origin) / dir;
+    if (ta > tb) { float tmp = ta; ta = tb; tb = tmp; }
+    if (ta > *t0) *t0 = ta;
+    if (tb < *t1) *t1 = tb;
+    return *t0 <= *t1;
+}
+
+// Exact test inside one heightfield cell: the bilinear surface minus the segment height is a
+// quadratic in t, so its maximum over [t0, t1] is at an end or at the vertex.
+static bool IsCellSurfaceAbove(const TerrainTrace* trace, int cx, int cz, float t0, float t1) {
+    const float* row0 = trace->heights + cz * TERRAIN_TILE_SAMPLES + cx;
+    const float* row1 = row0 + TERRAIN_TILE_SAMPLES;
+    float h00 = row0[0], h10 = row0[1], h01 = row1[0], h11 = row1[1];
+    float cellSize = trace->scene->terrainCellSize;
+    Vector3 from = trace->from;
+    Vector3 dir = trace->dir;
+    float u0 = (from.x - (trace->originX + (float)cx * cellSize)) / cellSize;
+    float v0 = (from.z - (trace->originZ + (float)cz * cellSize)) / cellSize;
+    float du = dir.x / cellSize;
+    float dv = dir.z / cellSize;
+
+    // h(u, v) = h00 + eu*u + ev*v + euv*u*v, minus y(t) = from.y + dir.y*t + tolerance
+    float eu = h10 - h00;
+    float ev = h01 - h00;
+    float euv = h00 - h10 - h01 + h11;
+    float a = euv * du * dv;
+    float b = eu * du + ev * dv + euv * (u0 * dv + v0 * du) - dir.y;
+    float c = h00 + eu * u0 + ev * v0 + euv * u0 * v0 - from.y - trace->tolerance;
+
+    if (a * t0 * t0 + b * t0 + c > 0.0f) return true;
+    if (a * t1 * t1 + b * t1 + c > 0.0f) return true;
+    if (a < 0.0f) {
+        float tv = -b / (2.0f * a);
+        if (tv > t0 && tv < t1 && a * tv * tv + b * tv + c > 0.0f) return true;
+    }
+    return false;
+}
+
+static bool TraceTerrainMaxNode(const TerrainTrace* trace, int level, int nx, int nz, float t0, float t1) {
+    const Scene* scene = trace->scene;
+    int span = 1 << level;
+    int cellX0 = nx * span;
+    int cellZ0 = nz * span;
+    int cellX1 = (cellX0 + span < WORLD_TILE_QUADS) ? cellX0 + span : WORLD_TILE_QUADS;
+    int cellZ1 = (cellZ0 + span < WORLD_TILE_QUADS) ? cellZ0 + span : WORLD_TILE_QUADS;
+    float cellSize = scene->terrainCellSize;
+    Vector3 from = trace->from;
+    Vector3 dir = trace->dir;
+    if (!ClipSegmentSlab(from.x, dir.x, trace->originX + (float)cellX0 * cellSize, trace->originX + (float)cellX1 * cellSize, &t0, &t1)) return false;
+    if (!ClipSegmentSlab(from.z, dir.z, trace->originZ + (float)cellZ0 * cellSize, trace->originZ + (float)cellZ1 * cellSize, &t0, &t1)) return false;
+
+    // The segment is linear, so its lowest point in this node is at one of the clipped ends
+    float segmentMinY = fminf(from.y + dir.y * t0, from.y + dir.y * t1);
+    float nodeMax = trace->pyramid[scene->terrainMaxLevelOffset[level] + nz * scene->terrainMaxLevelWidth[level] + nx];
+    if (nodeMax <= segmentMinY + trace->tolerance) return false;
+
+    if (level == 0) return IsCellSurfaceAbove(trace, nx, nz, t0, t1);
+
+    // Children nearest the segment origin first, so blocking ridges end the walk early
+    int childW = scene->terrainMaxLevelWidth[level - 1];
+    int firstX = (dir.x >= 0.0f) ? 0 : 1;
+    int firstZ = (dir.z >= 0.0f) ? 0 : 1;
+    for (int iz = 0; iz < 2; iz++) {
+        int cz = nz * 2 + (iz ^ firstZ);
+        if (cz >= childW) continue;
+        for (int ix = 0; ix < 2; ix++) {
+            int cx = nx * 2 + (ix ^ firstX);
+            if (cx >= childW) continue;
+            if (TraceTerrainMaxNode(trace, level - 1, cx, cz, t0, t1)) return true;
+        }
+    }
+    return false;
 }
 
-void UnloadScene(Scene scene) {
+bool IsTerrainSegmentOccluded(const Scene* scene, Vector3 from, Vector3 to, float tolerance) {
+    if (scene->terrainMaxPyramid == NULL) return false;
+    TerrainTrace trace = { .scene = scene, .from = from, .dir = Vector3Subtract(to, from), .tolerance = tolerance };
+    int top = scene->terrainMaxLevelCount - 1;
+    int tileX0 = (int)floorf(fminf(from.x, to.x) / WORLD_TILE_SIZE);
+    int tileX1 = (int)floorf(fmaxf(from.x, to.x) / WORLD_TILE_SIZE);
+    int tileZ0 = (int)floorf(fminf(from.z, to.z) / WORLD_TILE_SIZE);
+    int tileZ1 = (int)floorf(fmaxf(from.z, to.z) / WORLD_TILE_SIZE);
+    for (int tileZ = tileZ0; tileZ <= tileZ1; tileZ++) {
+        for (int tileX = tileX0; tileX <= tileX1; tileX++) {
+            if (!IsTerrainTileResident(scene, tileX, tileZ)) continue;
+            int slot = GetWorldTileSlot(tileX, tileZ);
+            trace.heights = scene->terrainHeights + slot * TERRAIN_TILE_SAMPLES * TERRAIN_TILE_SAMPLES;
+            trace.pyramid = scene->terrainMaxPyramid + slot * scene->terrainMaxPyramidSize;
+            trace.originX = (float)tileX * WORLD_TILE_SIZE;
+            trace.originZ = (float)tileZ * WORLD_TILE_SIZE;
+            if (TraceTerrainMaxNode(&trace, top, 0, 0, 0.0f, 1.0f)) return true;
+        }
+    }
+    return false;
+}
+
+void UnloadScene(Scene* scene) {
     // Unload models
-    UnloadModel(scene.terrainModel);
-    if (scene.wallModelNS.meshCount > 0) UnloadModel(scene.wallModelNS);
-    if (scene.wallModelEW.meshCount > 0) UnloadModel(scene.wallModelEW);
-    
+    for (int slot = 0; slot < TERRAIN_TILE_SLOTS; slot++) EvictTerrainTile(scene, slot);
+    if (scene->terrainPatchVao != 0) {
+        rlUnloadVertexArray(scene->terrainPatchVao);
+        rlUnloadVertexBuffer(scene->terrainPatchVbo);
+        rlUnloadVertexBuffer(scene->terrainPatchIbo);
+        rlUnloadVertexBuffer(scene->terrainNodeVbo);
+        rlUnloadVertexBuffer(scene->terrainTileVbo);
+    }
+    if (scene->terrainHeightTexture.id > 0) UnloadTexture(scene->terrainHeightTexture);
+    if (scene->terrainNormalTexture.id > 0) UnloadTexture(scene->terrainNormalTexture);
+    if (scene->wallModelNS.meshCount > 0) UnloadModel(scene->wallModelNS);
+    if (scene->wallModelEW.meshCount > 0) UnloadModel(scene->wallModelEW);
+
     // Unload textures
-    if (scene.wallTexture.id > 0) UnloadTexture(scene.wallTexture);
-    UnloadTexture(scene.floorTexture);
-    if (scene.floorNormalMap.id > 0) UnloadTexture(scene.floorNormalMap);
-    
+    if (scene->wallTexture.id > 0) UnloadTexture(scene->wallTexture);
+    UnloadTexture(scene->floorTexture);
+    if (scene->floorNormalMap.id > 0) UnloadTexture(scene->floorNormalMap);
+
     // Free allocated memory
-    free(scene.wallBoxes);
-    free(scene.terrainHeights);
+    free(scene->wallBoxes);
+    free(scene->terrainHeights);
+    free(scene->terrainMaxPyramid);
+    free(scene->terrainNodeMinY);
+    free(scene->terrainNodeMaxY);
+    free(scene->terrainNodeData);
+    free(scene->terrainTileData);
 }
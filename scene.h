@@ -2,6 +2,30 @@
 #define SCENE_H
 
 #include "common.h"
+#include "culling.h"
+#include "jobs.h"
+
+#define TERRAIN_MAX_PYRAMID_LEVELS 16  // Enough for a 32k-cell tile edge
+#define TERRAIN_LOD_MAX_LEVELS 12      // Quadtree depth cap for the CDLOD terrain
+#define TERRAIN_TILE_SAMPLES (WORLD_TILE_QUADS + 1) // Heights per tile edge, shared edges included
+#define TERRAIN_TILE_SLOTS (WORLD_WINDOW_TILES * WORLD_WINDOW_TILES)
+#define TERRAIN_GENERATE_ROW_GRAIN 8   // Apron rows per GenerateTerrainTile job chunk
+
+// One tile's heights and normals, generated off the main thread by GenerateTerrainTile
+typedef struct {
+    int tileX;
+    int tileZ;
+    float heights[TERRAIN_TILE_SAMPLES * TERRAIN_TILE_SAMPLES];
+    unsigned char normals[TERRAIN_TILE_SAMPLES * TERRAIN_TILE_SAMPLES * 4]; // RGBA8, xyz * 0.5 + 0.5
+    float apron[(TERRAIN_TILE_SAMPLES + 2) * (TERRAIN_TILE_SAMPLES + 2)];   // Scratch: heights plus a 1-sample border
+} TerrainTileData;
+
+// What a resident-window slot currently holds
+typedef struct {
+    int tileX;
+    int tileZ;
+    bool resident;
+} TerrainTileSlot;
 
 // Scene geometry
 typedef struct {
@@ -9,41 +33,110 @@ typedef struct {
     float roomLength;
     float wallHeight;
     float wallThickness;
-    int terrainWidth;
-    int terrainLength;
-    float terrainCellSizeX;
-    float terrainCellSizeZ;
+    unsigned int terrainSeed;
+    float terrainCellSize;         // WORLD_CELL_SIZE
     float terrainHeightScale;
+
+    // Streamed tiles: each slot's TERRAIN_TILE_SAMPLES^2 heights back to back
+    TerrainTileSlot terrainTiles[TERRAIN_TILE_SLOTS];
     float* terrainHeights;
-    
-    Model floorModel;
-    Model terrainModel;
+
+    // Per-tile max-height pyramid for hierarchical terrain rays. Level 0 holds each heightfield cell's
+    // highest corner (an upper bound of its bilinear surface); each level above takes the max of 2x2
+    // children. Every slot has the same layout.
+    float* terrainMaxPyramid;      // Slot after slot, all levels back to back, level 0 first
+    int terrainMaxPyramidSize;     // Floats per slot
+    int terrainMaxLevelCount;
+    int terrainMaxLevelOffset[TERRAIN_MAX_PYRAMID_LEVELS];
+    int terrainMaxLevelWidth[TERRAIN_MAX_PYRAMID_LEVELS];
+
+    // CDLOD terrain: a quadtree of square nodes per tile, all drawn with one shared TERRAIN_PATCH_QUADS grid.
+    // Level 0 nodes sample every heightfield vertex; each level up doubles node size and spacing.
+    // Vertices morph onto the next level's grid as they near the end of their level's range, so
+    // neighbouring levels meet without cracks.
+    Shader terrainShader;          // terrain.vs + lighting.fs (id 0 = coarse per-tile meshes in terrainModels)
+    int terrainShaderLocs[5];      // heightMap, normalMap, tileSamples, terrainCellSize, morphRange
+    Texture2D terrainHeightTexture; // R32F atlas, one TERRAIN_TILE_SAMPLES square per slot
+    Texture2D terrainNormalTexture; // RGBA8 atlas of the same layout
+    int terrainLodLevelCount;
+    float terrainLodRange[TERRAIN_LOD_MAX_LEVELS];  // Camera distance each level reaches (last = everything)
+    float* terrainNodeMinY;        // Per-node height bounds, slot after slot, all levels back to back
+    float* terrainNodeMaxY;
+    int terrainNodeCount;          // Nodes per slot
+    int terrainNodeLevelOffset[TERRAIN_LOD_MAX_LEVELS];
+    int terrainNodeLevelWidth[TERRAIN_LOD_MAX_LEVELS]; // Nodes per tile edge at each level
+    unsigned int terrainPatchVao;  // Grid patch plus the per-instance node streams
+    unsigned int terrainPatchVbo;
+    unsigned int terrainPatchIbo;
+    int terrainPatchIndexCount;
+    unsigned int terrainNodeVbo;
+    unsigned int terrainTileVbo;
+    float* terrainNodeData;        // Selected nodes this frame: origin x, origin z (tile samples), spacing, level
+    float* terrainTileData;        // Their tiles: world x, world z, atlas texel x, atlas texel y
+    int terrainNodeCapacity;
+    int terrainNodesDrawn;         // Nodes selected by the last DrawScene
+
+    Shader lightingShader;         // For the fallback meshes
+    Model terrainModels[TERRAIN_TILE_SLOTS]; // Coarse per-tile meshes, only built when the terrain shader failed
     Model wallModelNS;  // North/South walls
     Model wallModelEW;  // East/West walls
-    
+
     Texture2D wallTexture;
     Texture2D floorTexture;
     Texture2D floorNormalMap;
     bool floorHasNormalMap;
-    
+
     // Collision boxes for walls
     BoundingBox* wallBoxes;
     int numWalls;
 } Scene;
 
-// Initialize scene with dimensions and textures
-Scene InitScene(float width, float length, float height, float thickness, 
-                const char* wallTexturePath, const char* floorTexturePath, Shader lightingShader, unsigned int terrainSeed);
+// Initialize scene with dimensions and textures. No terrain is resident yet: tiles arrive through
+// CommitTerrainTile. They draw through terrainShader as CDLOD nodes; if it failed to load, coarse
+// per-tile meshes with lightingShader are used instead.
+Scene InitScene(float width, float length, float height, float thickness,
+                const char* wallTexturePath, const char* floorTexturePath, Shader lightingShader, Shader terrainShader,
+                unsigned int terrainSeed);
+
+// Heights and normals of tile (tileX, tileZ). Reads only immutable scene settings, so it is safe on
+// any thread; jobs (may be NULL) splits the noise evaluation across its threads by rows.
+void GenerateTerrainTile(const Scene* scene, int tileX, int tileZ, JobSystem* jobs, TerrainTileData* out);
+
+// Main thread: copy a generated tile into its slot, rebuild its bounds and upload it
+void CommitTerrainTile(Scene* scene, const TerrainTileData* tile);
+
+// Main thread: drop whatever tile the slot holds
+void EvictTerrainTile(Scene* scene, int slot);
+
+bool IsTerrainTileResident(const Scene* scene, int tileX, int tileZ);
 
-// Draw scene (walls, floor)
-void DrawScene(Scene scene);
+// Draw scene (walls, floor); selects and frustum-culls terrain nodes for this camera
+void DrawScene(Scene* scene, Camera3D camera);
 
 // Draw debug visualization for scene (bounding boxes)
-void DrawSceneDebug(Scene scene);
+void DrawSceneDebug(const Scene* scene);
+
+// Bilinear terrain height; tiles that are not resident are evaluated from the generator directly
+float GetTerrainHeightAt(const Scene* scene, float x, float z);
+
+// Batched GetTerrainHeightAt over SoA world x/z, 8 (AVX2) or 4 (SSE2) points at a time with a scalar tail.
+// Results match GetTerrainHeightAt exactly.
+void GetTerrainHeights(const Scene* scene, const float* xs, const float* zs, int count, float* outHeights);
+
+// Unit normals of the same bilinear surface (normal.y is the cosine of the slope)
+void GetTerrainNormals(const Scene* scene, const float* xs, const float* zs, int count, Vector3* outNormals);
+
+// The same two queries over one generated tile, for placement before the tile is committed. Positions
+// are in tile samples (0..WORLD_TILE_QUADS) and clamped to the tile.
+void SampleTerrainTileHeights(const TerrainTileData* tile, const float* gxs, const float* gzs, int count, float* outHeights);
+void SampleTerrainTileNormals(const TerrainTileData* tile, const float* gxs, const float* gzs, int count, Vector3* outNormals);
 
-float GetTerrainHeightAt(Scene scene, float x, float z);
+// True if the bilinear terrain surface rises more than tolerance above the segment from -> to.
+// Exact per heightfield cell; whole pyramid nodes the segment clears are skipped. Tiles that are not
+// resident never occlude.
+bool IsTerrainSegmentOccluded(const Scene* scene, Vector3 from, Vector3 to, float tolerance);
 
 // Unload scene resources
-void UnloadScene(Scene scene);
+void UnloadScene(Scene* scene);
 
 #endif // SCENE_H
@@ -0,0 +1,159 @@
+// Determinism checks behind the baked tile cache (make check):
+// - the SSE2/AVX2 terrain noise lanes give bit-identical heights to the scalar GenerateTerrainHeight
+// - the lane and scalar tile queries give bit-identical heights and normals
+// - neighbouring tiles generate identical shared edges
+// - terrain tiles and prop scatter don't depend on the job system's thread count
+// Built once without and once with -mavx2 so both lane widths are compared against the scalar code.
+// scene.c is included rather than linked so its static noise functions can be called directly.
+#include "scene.c"
+#include "props.h"
+#include <stdio.h>
+
+#define CHECK_SEED_COUNT 3
+#define CHECK_ROWS 64
+#define CHECK_QUERY_POINTS 4096
+
+static const unsigned int CHECK_SEEDS[CHECK_SEED_COUNT] = { WORLD_DEFAULT_SEED, 1u, 0xdeadbeefu };
+static const int CHECK_WORKER_COUNTS[] = { 1, 3, 7 }; // 2, 4 and 8 threads; jobs == NULL covers 1
+
+static int failures = 0;
+
+static void Report(bool ok, const char* what) {
+    printf("%s: %s\n", ok ? "INFO: ok" : "ERROR: mismatch", what);
+    if (!ok) failures++;
+}
+
+static Scene MakeCheckScene(unsigned int seed) {
+    Scene scene = {0};
+    scene.terrainSeed = seed;
+    scene.terrainCellSize = WORLD_CELL_SIZE;
+    scene.terrainHeightScale = 4.8f; // InitScene's value
+    return scene;
+}
+
+// Every lane of GenerateTerrainHeightLanes against GenerateTerrainHeight, around the origin and far out
+static void CheckNoiseLanes(const Scene* scene) {
+#ifdef NOISE_LANES
+    const int origins[3][2] = { { -64, -32 }, { 0, 0 }, { 250000, -180000 } };
+    long samples = 0;
+    long mismatches = 0;
+    for (int o = 0; o < 3; o++) {
+        for (int z = 0; z < CHECK_ROWS; z++) {
+            for (int x = 0; x < 4 * WORLD_TILE_QUADS; x += NOISE_LANES) {
+                int sx = origins[o][0] + x;
+                int sz = origins[o][1] + z;
+                float lanes[NOISE_LANES];
+                GenerateTerrainHeightLanes(scene, sx, sz, lanes);
+                for (int l = 0; l < NOISE_LANES; l++) {
+                    float scalar = GenerateTerrainHeight(scene, sx + l, sz);
+                    if (memcmp(&scalar, &lanes[l], sizeof(float)) != 0) mismatches++;
+                    samples++;
+                }
+            }
+        }
+    }
+    char what[128];
+    snprintf(what, sizeof(what), "%d-wide noise lanes vs scalar, seed %08x (%ld samples, %ld differ)",
+             NOISE_LANES, scene->terrainSeed, samples, mismatches);
+    Report(mismatches == 0, what);
+#else
+    (void)scene;
+    printf("INFO: skipped noise lanes (no SSE2/AVX2 in this build)\n");
+#endif
+}
+
+// Batched tile queries (lanes plus tail) against one point at a time (always the scalar tail)
+static void CheckTileQueries(const TerrainTileData* tile) {
+    static float gxs[CHECK_QUERY_POINTS], gzs[CHECK_QUERY_POINTS];
+    static float heights[CHECK_QUERY_POINTS];
+    static Vector3 normals[CHECK_QUERY_POINTS];
+    unsigned int state = 12345u;
+    for (int i = 0; i < CHECK_QUERY_POINTS; i++) {
+        // Slightly past both ends of the tile to cover the clamp
+        state = state * 1664525u + 1013904223u;
+        gxs[i] = (float)(state >> 8) / 16777216.0f * (WORLD_TILE_QUADS + 2.0f) - 1.0f;
+        state = state * 1664525u + 1013904223u;
+        gzs[i] = (float)(state >> 8) / 16777216.0f * (WORLD_TILE_QUADS + 2.0f) - 1.0f;
+    }
+    SampleTerrainTileHeights(tile, gxs, gzs, CHECK_QUERY_POINTS, heights);
+    SampleTerrainTileNormals(tile, gxs, gzs, CHECK_QUERY_POINTS, normals);
+    int mismatches = 0;
+    for (int i = 0; i < CHECK_QUERY_POINTS; i++) {
+        float height;
+        Vector3 normal;
+        SampleTerrainTileHeights(tile, &gxs[i], &gzs[i], 1, &height);
+        SampleTerrainTileNormals(tile, &gxs[i], &gzs[i], 1, &normal);
+        if (memcmp(&height, &heights[i], sizeof(float)) != 0 || memcmp(&normal, &normals[i], sizeof(Vector3)) != 0) mismatches++;
+    }
+    char what[128];
+    snprintf(what, sizeof(what), "batched tile queries vs single points (%d points, %d differ)", CHECK_QUERY_POINTS, mismatches);
+    Report(mismatches == 0, what);
+}
+
+static bool SameTerrainTile(const TerrainTileData* a, const TerrainTileData* b) {
+    return memcmp(a->heights, b->heights, sizeof(a->heights)) == 0 && memcmp(a->normals, b->normals, sizeof(a->normals)) == 0;
+}
+
+static bool SamePropTile(const PropTileData* a, const PropTileData* b) {
+    return a->count == b->count && memcmp(a->positions, b->positions, (size_t)a->count * sizeof(Vector3)) == 0 &&
+           memcmp(a->types, b->types, (size_t)a->count) == 0;
+}
+
+int main(void) {
+#ifdef __AVX2__
+    if (!__builtin_cpu_supports("avx2")) {
+        printf("INFO: skipped, this CPU has no AVX2\n");
+        return 0;
+    }
+#endif
+    TerrainTileData* reference = (TerrainTileData*)malloc(sizeof(TerrainTileData));
+    TerrainTileData* other = (TerrainTileData*)malloc(sizeof(TerrainTileData));
+    PropTileData* propsReference = (PropTileData*)malloc(sizeof(PropTileData));
+    PropTileData* propsOther = (PropTileData*)malloc(sizeof(PropTileData));
+    if (reference == NULL || other == NULL || propsReference == NULL || propsOther == NULL) {
+        printf("ERROR: Out of memory\n");
+        return 1;
+    }
+
+    for (int s = 0; s < CHECK_SEED_COUNT; s++) {
+        Scene scene = MakeCheckScene(CHECK_SEEDS[s]);
+        CheckNoiseLanes(&scene);
+
+        GenerateTerrainTile(&scene, -1, 2, NULL, reference);
+        CheckTileQueries(reference);
+
+        // Tile (0, 2)'s first column is tile (-1, 2)'s last
+        GenerateTerrainTile(&scene, 0, 2, NULL, other);
+        bool edgeMatches = true;
+        for (int z = 0; z < TERRAIN_TILE_SAMPLES; z++) {
+            const float* left = &reference->heights[z * TERRAIN_TILE_SAMPLES + WORLD_TILE_QUADS];
+            const float* right = &other->heights[z * TERRAIN_TILE_SAMPLES];
+            if (memcmp(left, right, sizeof(float)) != 0) edgeMatches = false;
+        }
+        Report(edgeMatches, "shared tile edge heights");
+
+        GeneratePropTile(reference, 3125, 625, CHECK_SEEDS[s], NULL, propsReference);
+        for (size_t w = 0; w < sizeof(CHECK_WORKER_COUNTS) / sizeof(CHECK_WORKER_COUNTS[0]); w++) {
+            JobSystem jobs = InitJobSystem(CHECK_WORKER_COUNTS[w]);
+            char what[128];
+            GenerateTerrainTile(&scene, -1, 2, &jobs, other);
+            snprintf(what, sizeof(what), "terrain tile with %d job threads", GetJobThreadCount(&jobs));
+            Report(SameTerrainTile(reference, other), what);
+            GeneratePropTile(reference, 3125, 625, CHECK_SEEDS[s], &jobs, propsOther);
+            snprintf(what, sizeof(what), "prop scatter with %d job threads (%d props)", GetJobThreadCount(&jobs), propsOther->count);
+            Report(SamePropTile(propsReference, propsOther), what);
+            UnloadJobSystem(&jobs);
+        }
+    }
+
+    free(reference);
+    free(other);
+    free(propsReference);
+    free(propsOther);
+    if (failures > 0) {
+        printf("ERROR: %d determinism checks failed\n", failures);
+        return 1;
+    }
+    printf("INFO: All determinism checks passed\n");
+    return 0;
+}
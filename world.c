@@ -0,0 +1,440 @@
+#define _POSIX_C_SOURCE 200809L
+#include "world.h"
+#include <pthread.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+typedef enum {
+    WORLD_SLOT_QUEUED,       // Wants its window tile; the generator has not picked it up
+    WORLD_SLOT_GENERATING,
+    WORLD_SLOT_READY,        // Generated, waiting in a buffer for the main thread
+    WORLD_SLOT_RESIDENT
+} WorldSlotState;
+
+typedef enum {
+    WORLD_BUFFER_FREE,
+    WORLD_BUFFER_GENERATING,
+    WORLD_BUFFER_READY
+} WorldBufferState;
+
+typedef struct {
+    WorldBufferState state;
+    int tileX;
+    int tileZ;
+    TerrainTileData terrain;
+    PropTileData props;
+} WorldTileBuffer;
+
+struct WorldStreamerState {
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;     // Generator: a slot was queued, a buffer freed, or quit
+    pthread_cond_t ready;    // Main thread: a buffer finished (WaitForWorldTiles)
+    bool quit;
+
+    const Scene* scene;
+    JobSystem jobs;          // Generator-only pool (noise rows, scatter chunks); the frame's pool is busy with LOS and culling
+    unsigned int seed;
+    int grassPerTile;
+    int rocksPerTile;
+    unsigned int paramsHash; // GetWorldParamsHash of the settings above
+    char cacheDir[256];      // Empty when baked tiles are disabled
+
+    // Everything below is guarded by mutex
+    int centerTileX;         // Camera tile; the generator works outward from it
+    int centerTileZ;
+    int wantX[TERRAIN_TILE_SLOTS];   // Window tile each slot should hold
+    int wantZ[TERRAIN_TILE_SLOTS];
+    WorldSlotState slots[TERRAIN_TILE_SLOTS];
+    WorldTileBuffer buffers[WORLD_STREAM_BUFFERS];
+};
+
+// Nearest queued slot to the camera tile, or -1
+static int PickQueuedSlot(const WorldStreamerState* state) {
+    int best = -1;
+    int bestDistance = INT_MAX;
+    for (int slot = 0; slot < TERRAIN_TILE_SLOTS; slot++) {
+        if (state->slots[slot] != WORLD_SLOT_QUEUED) continue;
+        int dx = abs(state->wantX[slot] - state->centerTileX);
+        int dz = abs(state->wantZ[slot] - state->centerTileZ);
+        int distance = (dx > dz) ? dx : dz;
+        if (distance < bestDistance) {
+            best = slot;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+static int FindBuffer(const WorldStreamerState* state, WorldBufferState bufferState) {
+    for (int b = 0; b < WORLD_STREAM_BUFFERS; b++) {
+        if (state->buffers[b].state == bufferState) return b;
+    }
+    return -1;
+}
+
+// Baked tile: this header, then heights, normals, prop positions and prop types exactly as they sit in
+// TerrainTileData/PropTileData (fixed capacity), so a warm load is an mmap and copies with nothing to parse
+typedef struct {
+    char magic[4];           // "RMWT"
+    unsigned int version;    // WORLD_FILE_VERSION
+    unsigned int seed;
+    unsigned int paramsHash;
+    int tileX;
+    int tileZ;
+    int propCount;
+    int propCapacity;
+} WorldTileFileHeader;
+
+#define WORLD_TILE_FILE_SIZE (sizeof(WorldTileFileHeader) + \
+    sizeof(((TerrainTileData*)0)->heights) + sizeof(((TerrainTileData*)0)->normals) + \
+    sizeof(((PropTileData*)0)->positions) + sizeof(((PropTileData*)0)->types))
+
+// FNV-1a over everything besides the seed that changes what a tile contains
+static unsigned int GetWorldParamsHash(const Scene* scene, int grassPerTile, int rocksPerTile) {
+    unsigned int params[7] = { WORLD_FILE_VERSION, WORLD_TILE_QUADS, 0, 0, (unsigned int)grassPerTile,
+                               (unsigned int)rocksPerTile, PROPS_TILE_CAPACITY };
+    memcpy(&params[2], &scene->terrainCellSize, sizeof(float));
+    memcpy(&params[3], &scene->terrainHeightScale, sizeof(float));
+    unsigned int hash = 2166136261u;
+    const unsigned char* bytes = (const unsigned char*)params;
+    for (size_t i = 0; i < sizeof(params); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void GetWorldTilePath(const WorldStreamerState* state, int tileX, int tileZ, char* path, size_t pathSize) {
+    snprintf(path, pathSize, "%s/%d_%d.tile", state->cacheDir, tileX, tileZ);
+}
+
+static bool LoadWorldTileFile(const WorldStreamerState* state, int tileX, int tileZ, TerrainTileData* terrain, PropTileData* props) {
+    char path[320];
+    GetWorldTilePath(state, tileX, tileZ, path, sizeof(path));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    bool loaded = false;
+    struct stat info;
+    if (fstat(fd, &info) == 0 && (size_t)info.st_size == WORLD_TILE_FILE_SIZE) {
+        void* mapped = mmap(NULL, WORLD_TILE_FILE_SIZE, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            const WorldTileFileHeader* header = (const WorldTileFileHeader*)mapped;
+            if (memcmp(header->magic, "RMWT", 4) == 0 && header->version == WORLD_FILE_VERSION &&
+                header->seed == state->seed && header->paramsHash == state->paramsHash &&
+                header->tileX == tileX && header->tileZ == tileZ &&
+                header->propCapacity == PROPS_TILE_CAPACITY &&
+                header->propCount >= 0 && header->propCount <= PROPS_TILE_CAPACITY) {
+                const unsigned char* data = (const unsigned char*)(header + 1);
+                terrain->tileX = tileX;
+                terrain->tileZ = tileZ;
+                memcpy(terrain->heights, data, sizeof(terrain->heights));
+                data += sizeof(terrain->heights);
+                memcpy(terrain->normals, data, sizeof(terrain->normals));
+                data += sizeof(terrain->normals);
+                props->tileX = tileX;
+                props->tileZ = tileZ;
+                props->count = header->propCount;
+                memcpy(props->positions, data, (size_t)props->count * sizeof(Vector3));
+                data += sizeof(props->positions);
+                memcpy(props->types, data, (size_t)props->count);
+                loaded = true;
+            }
+            munmap(mapped, WORLD_TILE_FILE_SIZE);
+        }
+    }
+    close(fd);
+    return loaded;
+}
+
+// Written beside the final name and renamed, so a crash never leaves a truncated tile behind
+static void SaveWorldTileFile(const WorldStreamerState* state, const TerrainTileData* terrain, const PropTileData* props) {
+    char path[320];
+    char tempPath[330];
+    GetWorldTilePath(state, terrain->tileX, terrain->tileZ, path, sizeof(path));
+    snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+    FILE* file = fopen(tempPath, "wb");
+    if (file == NULL) return;
+
+    WorldTileFileHeader header = { { 'R', 'M', 'W', 'T' }, WORLD_FILE_VERSION, state->seed, state->paramsHash,
+                                   terrain->tileX, terrain->tileZ, props->count, PROPS_TILE_CAPACITY };
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(terrain->heights, sizeof(terrain->heights), 1, file) == 1 &&
+                   fwrite(terrain->normals, sizeof(terrain->normals), 1, file) == 1 &&
+                   fwrite(props->positions, sizeof(props->positions), 1, file) == 1 &&
+                   fwrite(props->types, sizeof(props->types), 1, file) == 1;
+    if (fclose(file) != 0) written = false;
+    if (!written || rename(tempPath, path) != 0) {
+        printf("WARNING: Failed to write baked world tile %s\n", path);
+        remove(tempPath);
+    }
+}
+
+// A seed directory of WORLD_CACHE_DIR and when it was last used
+typedef struct {
+    char name[32];
+    time_t used;
+} WorldCacheEntry;
+
+static int CompareWorldCacheEntries(const void* a, const void* b) {
+    time_t usedA = ((const WorldCacheEntry*)a)->used;
+    time_t usedB = ((const WorldCacheEntry*)b)->used;
+    return (usedA < usedB) - (usedA > usedB); // Most recently used first
+}
+
+// Only "<seed>_<hash>" directories are ours to delete
+static bool IsWorldCacheDirName(const char* name) {
+    if (strlen(name) != 17 || name[8] != '_') return false;
+    for (int i = 0; i < 17; i++) {
+        if (i != 8 && strchr("0123456789abcdef", name[i]) == NULL) return false;
+    }
+    return true;
+}
+
+static void RemoveWorldCacheDir(const char* name) {
+    char dirPath[320];
+    snprintf(dirPath, sizeof(dirPath), "%s/%s", WORLD_CACHE_DIR, name);
+    DIR* dir = opendir(dirPath);
+    if (dir == NULL) return;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') continue;
+        char filePath[640];
+        snprintf(filePath, sizeof(filePath), "%s/%s", dirPath, entry->d_name);
+        unlink(filePath);
+    }
+    closedir(dir);
+    if (rmdir(dirPath) == 0) printf("INFO: Pruned baked world %s\n", dirPath);
+}
+
+// Mark the current seed directory used and delete all but the WORLD_CACHE_MAX_WORLDS most recently used
+static void PruneWorldCache(const char* currentDir) {
+    utimensat(AT_FDCWD, currentDir, NULL, 0);
+    DIR* dir = opendir(WORLD_CACHE_DIR);
+    if (dir == NULL) return;
+    WorldCacheEntry entries[64];
+    int count = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL && count < 64) {
+        if (!IsWorldCacheDirName(entry->d_name)) continue;
+        char path[320];
+        struct stat info;
+        snprintf(path, sizeof(path), "%s/%s", WORLD_CACHE_DIR, entry->d_name);
+        if (stat(path, &info) != 0 || !S_ISDIR(info.st_mode)) continue;
+        memcpy(entries[count].name, entry->d_name, 18); // Name checked above: 17 characters + NUL
+        entries[count].used = info.st_mtime;
+        count++;
+    }
+    closedir(dir);
+    qsort(entries, count, sizeof(WorldCacheEntry), CompareWorldCacheEntries);
+    for (int i = WORLD_CACHE_MAX_WORLDS; i < count; i++) RemoveWorldCacheDir(entries[i].name);
+}
+
+static void* WorldGeneratorMain(void* arg) {
+    WorldStreamerState* state = (WorldStreamerState*)arg;
+    pthread_mutex_lock(&state->mutex);
+    for (;;) {
+        int slot = -1;
+        int b = -1;
+        while (!state->quit && ((b = FindBuffer(state, WORLD_BUFFER_FREE)) < 0 || (slot = PickQueuedSlot(state)) < 0)) {
+            pthread_cond_wait(&state->wake, &state->mutex);
+        }
+        if (state->quit) break;
+
+        WorldTileBuffer* buffer = &state->buffers[b];
+        buffer->state = WORLD_BUFFER_GENERATING;
+        buffer->tileX = state->wantX[slot];
+        buffer->tileZ = state->wantZ[slot];
+        state->slots[slot] = WORLD_SLOT_GENERATING;
+        pthread_mutex_unlock(&state->mutex);
+
+        bool baked = state->cacheDir[0] != '\0' &&
+                     LoadWorldTileFile(state, buffer->tileX, buffer->tileZ, &buffer->terrain, &buffer->props);
+        if (!baked) {
+            GenerateTerrainTile(state->scene, buffer->tileX, buffer->tileZ, &state->jobs, &buffer->terrain);
+            GeneratePropTile(&buffer->terrain, state->grassPerTile, state->rocksPerTile, state->seed, &state->jobs, &buffer->props);
+            if (state->cacheDir[0] != '\0') SaveWorldTileFile(state, &buffer->terrain, &buffer->props);
+        }
+
+        pthread_mutex_lock(&state->mutex);
+        buffer->state = WORLD_BUFFER_READY;
+        // The window may have moved on meanwhile; then the slot was re-queued and this result is stale
+        if (state->slots[slot] == WORLD_SLOT_GENERATING &&
+            state->wantX[slot] == buffer->tileX && state->wantZ[slot] == buffer->tileZ) {
+            state->slots[slot] = WORLD_SLOT_READY;
+        }
+        pthread_cond_broadcast(&state->ready);
+    }
+    pthread_mutex_unlock(&state->mutex);
+    return NULL;
+}
+
+WorldStreamer InitWorldStreamer(const Scene* scene, unsigned int seed, int grassPerTile, int rocksPerTile) {
+    WorldStreamer world = {0};
+    world.windowTileX = INT_MIN; // No window until the first update
+    WorldStreamerState* state = (WorldStreamerState*)calloc(1, sizeof(WorldStreamerState));
+    if (state == NULL) return world;
+    state->scene = scene;
+    state->seed = seed;
+    state->grassPerTile = grassPerTile;
+    state->rocksPerTile = rocksPerTile;
+    state->paramsHash = GetWorldParamsHash(scene, grassPerTile, rocksPerTile);
+    snprintf(state->cacheDir, sizeof(state->cacheDir), "%s/%08x_%08x", WORLD_CACHE_DIR, seed, state->paramsHash);
+    if ((mkdir(WORLD_CACHE_DIR, 0755) != 0 && errno != EEXIST) || (mkdir(state->cacheDir, 0755) != 0 && errno != EEXIST)) {
+        printf("WARNING: Cannot create %s, world tiles will not be baked\n", state->cacheDir);
+        state->cacheDir[0] = '\0';
+    } else {
+        PruneWorldCache(state->cacheDir);
+    }
+    for (int slot = 0; slot < TERRAIN_TILE_SLOTS; slot++) {
+        state->wantX[slot] = INT_MIN;
+        state->slots[slot] = WORLD_SLOT_RESIDENT; // Nothing wanted yet
+    }
+    pthread_mutex_init(&state->mutex, NULL);
+    pthread_cond_init(&state->wake, NULL);
+    pthread_cond_init(&state->ready, NULL);
+    state->jobs = InitJobSystem(WORLD_GENERATOR_WORKERS);
+    if (pthread_create(&state->thread, NULL, WorldGeneratorMain, state) != 0) {
+        printf("ERROR: Failed to start the world generator thread\n");
+        UnloadJobSystem(&state->jobs);
+        pthread_cond_destroy(&state->ready);
+        pthread_cond_destroy(&state->wake);
+        pthread_mutex_destroy(&state->mutex);
+        free(state);
+        return world;
+    }
+    world.state = state;
+    printf("INFO: World streaming: %dx%d tiles of %.1fm resident, %d grass and %d rocks per tile\n",
+           WORLD_WINDOW_TILES, WORLD_WINDOW_TILES, WORLD_TILE_SIZE, grassPerTile, rocksPerTile);
+    if (state->cacheDir[0] != '\0') printf("INFO: Baked world tiles in %s\n", state->cacheDir);
+    return world;
+}
+
+// Move the window once the camera leaves its central two tiles, so walking back and forth over a tile
+// edge does not evict and regenerate a whole row each time. Caller holds the mutex.
+static void RecenterWorldWindow(WorldStreamer* world, Scene* scene, Props* props, int tileX, int tileZ) {
+    WorldStreamerState* state = world->state;
+    const int half = WORLD_WINDOW_TILES / 2;
+    state->centerTileX = tileX;
+    state->centerTileZ = tileZ;
+    int windowX = world->windowTileX;
+    int windowZ = world->windowTileZ;
+    if (windowX == INT_MIN) {
+        windowX = tileX - half;
+        windowZ = tileZ - half;
+    }
+    if (tileX < windowX + half - 1) windowX = tileX - half;
+    else if (tileX > windowX + half) windowX = tileX - half + 1;
+    if (tileZ < windowZ + half - 1) windowZ = tileZ - half;
+    else if (tileZ > windowZ + half) windowZ = tileZ - half + 1;
+    if (windowX == world->windowTileX && windowZ == world->windowTileZ) return;
+
+    world->windowTileX = windowX;
+    world->windowTileZ = windowZ;
+    SetPropGridWindow(props, windowX, windowZ);
+    bool queued = false;
+    for (int z = windowZ; z < windowZ + WORLD_WINDOW_TILES; z++) {
+        for (int x = windowX; x < windowX + WORLD_WINDOW_TILES; x++) {
+            int slot = GetWorldTileSlot(x, z);
+            if (state->wantX[slot] == x && state->wantZ[slot] == z) continue;
+            state->wantX[slot] = x;
+            state->wantZ[slot] = z;
+            state->slots[slot] = WORLD_SLOT_QUEUED;
+            EvictTerrainTile(scene, slot);
+            EvictPropTile(props, slot);
+            queued = true;
+        }
+    }
+    if (queued) pthread_cond_signal(&state->wake);
+}
+
+// Upload up to maxCommits finished tiles and recycle stale buffers. Caller holds the mutex.
+static void CommitWorldTiles(WorldStreamer* world, Scene* scene, Props* props, int maxCommits) {
+    WorldStreamerState* state = world->state;
+    int commits = 0;
+    bool freed = false;
+    for (int b = 0; b < WORLD_STREAM_BUFFERS && commits < maxCommits; b++) {
+        WorldTileBuffer* buffer = &state->buffers[b];
+        if (buffer->state != WORLD_BUFFER_READY) continue;
+        int slot = GetWorldTileSlot(buffer->tileX, buffer->tileZ);
+        bool wanted = state->wantX[slot] == buffer->tileX && state->wantZ[slot] == buffer->tileZ;
+        if (wanted && state->slots[slot] != WORLD_SLOT_RESIDENT) {
+            CommitTerrainTile(scene, &buffer->terrain);
+            CommitPropTile(props, &buffer->props);
+            state->slots[slot] = WORLD_SLOT_RESIDENT;
+            commits++;
+        }
+        buffer->state = WORLD_BUFFER_FREE;
+        freed = true;
+    }
+    if (freed) pthread_cond_signal(&state->wake);
+
+    world->residentTiles = 0;
+    for (int slot = 0; slot < TERRAIN_TILE_SLOTS; slot++) {
+        if (state->slots[slot] == WORLD_SLOT_RESIDENT) world->residentTiles++;
+    }
+    world->pendingTiles = TERRAIN_TILE_SLOTS - world->residentTiles;
+}
+
+static void GetCameraTile(Vector3 cameraPosition, int* tileX, int* tileZ) {
+    *tileX = (int)floorf(cameraPosition.x / WORLD_TILE_SIZE);
+    *tileZ = (int)floorf(cameraPosition.z / WORLD_TILE_SIZE);
+}
+
+void UpdateWorldStreaming(WorldStreamer* world, Scene* scene, Props* props, Vector3 cameraPosition) {
+    WorldStreamerState* state = world->state;
+    if (state == NULL) return;
+    int tileX, tileZ;
+    GetCameraTile(cameraPosition, &tileX, &tileZ);
+    pthread_mutex_lock(&state->mutex);
+    RecenterWorldWindow(world, scene, props, tileX, tileZ);
+    CommitWorldTiles(world, scene, props, WORLD_COMMITS_PER_FRAME);
+    pthread_mutex_unlock(&state->mutex);
+}
+
+void WaitForWorldTiles(WorldStreamer* world, Scene* scene, Props* props, Vector3 cameraPosition, int radius) {
+    WorldStreamerState* state = world->state;
+    if (state == NULL) return;
+    int tileX, tileZ;
+    GetCameraTile(cameraPosition, &tileX, &tileZ);
+    pthread_mutex_lock(&state->mutex);
+    RecenterWorldWindow(world, scene, props, tileX, tileZ);
+    for (;;) {
+        CommitWorldTiles(world, scene, props, WORLD_STREAM_BUFFERS);
+        bool done = true;
+        for (int z = tileZ - radius; z <= tileZ + radius && done; z++) {
+            for (int x = tileX - radius; x <= tileX + radius; x++) {
+                if (state->slots[GetWorldTileSlot(x, z)] != WORLD_SLOT_RESIDENT) {
+                    done = false;
+                    break;
+                }
+            }
+        }
+        if (done) break;
+        pthread_cond_wait(&state->ready, &state->mutex);
+    }
+    pthread_mutex_unlock(&state->mutex);
+}
+
+void UnloadWorldStreamer(WorldStreamer* world) {
+    WorldStreamerState* state = world->state;
+    if (state == NULL) return;
+    pthread_mutex_lock(&state->mutex);
+    state->quit = true;
+    pthread_cond_broadcast(&state->wake);
+    pthread_mutex_unlock(&state->mutex);
+    pthread_join(state->thread, NULL);
+    UnloadJobSystem(&state->jobs);
+    pthread_cond_destroy(&state->ready);
+    pthread_cond_destroy(&state->wake);
+    pthread_mutex_destroy(&state->mutex);
+    free(state);
+    world->state = NULL;
+}
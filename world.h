@@ -0,0 +1,35 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "common.h"
+#include "scene.h"
+#include "props.h"
+
+typedef struct WorldStreamerState WorldStreamerState;
+
+// Keeps the WORLD_WINDOW_TILES^2 tiles around the camera resident. A background thread generates
+// terrain and props for missing tiles, nearest first; the main thread uploads at most
+// WORLD_COMMITS_PER_FRAME finished tiles per frame and evicts tiles the window has left. Generated
+// tiles are baked to WORLD_CACHE_DIR under the seed and generation parameters; later runs with the same
+// key map them back in instead of generating. Only the WORLD_CACHE_MAX_WORLDS most recently used keys are
+// kept.
+typedef struct {
+    int windowTileX;         // Min corner of the resident window in tiles
+    int windowTileZ;
+    int residentTiles;
+    int pendingTiles;        // Window tiles not committed yet
+    WorldStreamerState* state;
+} WorldStreamer;
+
+// scene must stay at the same address while the streamer runs (the generator reads its terrain settings)
+WorldStreamer InitWorldStreamer(const Scene* scene, unsigned int seed, int grassPerTile, int rocksPerTile);
+
+// Recenter the window on the camera and commit finished tiles (once per frame)
+void UpdateWorldStreaming(WorldStreamer* world, Scene* scene, Props* props, Vector3 cameraPosition);
+
+// Block until every tile within radius tiles of the camera's tile is resident (startup)
+void WaitForWorldTiles(WorldStreamer* world, Scene* scene, Props* props, Vector3 cameraPosition, int radius);
+
+void UnloadWorldStreamer(WorldStreamer* world);
+
+#endif // WORLD_H